@@ -3,5 +3,5 @@
 for file in ./generated/*.txt
 do
     echo ${file}
-	time timeout 5m ../Quelltext/stromralley solve ${file} >> /dev/null
+	time ../Quelltext/stromralley solve ${file} --time-limit 300 >> /dev/null
 done
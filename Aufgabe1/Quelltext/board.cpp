@@ -0,0 +1,279 @@
+#include "board.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+/********************
+ *    Konstanten    *
+ ********************/
+
+static const char BOARD_MAGIC[4] = { 'S', 'R', 'L', 'B' };
+
+/****************************
+ *    Statische typedefs    *
+ ****************************/
+
+// Liest Werte mit 16 oder 32 Bit aus dem Puffer und prueft dabei die Grenzen
+typedef struct board_reader_t
+{
+	const char *data;
+	size_t size;
+	size_t pos = 0;
+	bool wide = false;
+
+	// Sind noch mindestens count Werte im Puffer?
+	bool has(size_t count) const
+	{
+		size_t width = wide ? sizeof(uint32_t) : sizeof(uint16_t);
+		return (size - pos) / width >= count;
+	}
+
+	bool read(uint32_t *values, size_t count)
+	{
+		size_t width = wide ? sizeof(uint32_t) : sizeof(uint16_t);
+
+		if (!has(count))
+			return false;
+
+		if (wide)
+			std::memcpy(values, data + pos, count * width);
+		else
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				uint16_t value;
+				std::memcpy(&value, data + pos + i * width, width);
+				values[i] = value;
+			}
+		}
+
+		pos += count * width;
+		return true;
+	}
+} board_reader_t;
+
+/************************************************
+ *    Oeffentliche Methoden Implementationen    *
+ ************************************************/
+
+// Spielfeld im Textformat: Groesse, Roboter, Anzahl und die
+// Batterien in Feldreihenfolge, alle Koordinaten ab 1
+std::string boardText(const map_t &map)
+{
+	std::ostringstream text;
+	text << map.size << '\n';
+
+	point_t robot = decode(map.robot.position, map.size);
+	text << robot.x + 1 << ',' << robot.y + 1 << ',' << map.robot.charge << '\n';
+
+	text << map.batteries.size() << '\n';
+	for (uint32_t position = 0; position < map.area; position++)
+	{
+		uint32_t id = map.grid[position];
+		if (id == NO_BATTERY) continue;
+
+		point_t pos = decode(position, map.size);
+		text << pos.x + 1 << ',' << pos.y + 1 << ',' << map.charges[id] << '\n';
+	}
+
+	return text.str();
+}
+
+// Schreibt das Spielfeld als Text oder bei der Endung .srb im
+// Binaerformat; graph gilt nur fuer das Binaerformat
+bool writeBoard(const map_t &map, const std::string &path, bool graph, unsigned threads)
+{
+	if (isBinaryPath(path))
+		return writeBinaryBoard(map, path, graph, threads);
+
+	std::ofstream output(path);
+	output << boardText(map);
+	output.close();
+
+	return !output.fail();
+}
+
+// Soll die Datei binaer geschrieben werden?
+bool isBinaryPath(const std::string &path)
+{
+	return path.size() >= 4 && path.compare(path.size() - 4, 4, ".srb") == 0;
+}
+
+// Beginnt der Dateiinhalt mit der Kennung des Binaerformats?
+bool isBinaryBoard(const std::vector<char> &data)
+{
+	return data.size() >= sizeof(BOARD_MAGIC) && std::memcmp(data.data(), BOARD_MAGIC, sizeof(BOARD_MAGIC)) == 0;
+}
+
+// Liest ein Spielfeld im Binaerformat. Die Batterien werden direkt in
+// die Arrays von map gelesen, eine enthaltene Adjazenzmatrix ersetzt
+// parseGraph. Gibt nullptr oder den Grund des Fehlers zurueck.
+const char* readBinaryBoard(const std::vector<char> &data, map_t &map)
+{
+	board_reader_t reader = { data.data(), data.size() };
+	reader.pos = sizeof(BOARD_MAGIC);
+
+	// Version und Flags
+	uint32_t header[4];
+	if (!reader.read(header, 2))
+		return "unerwartetes Dateiende";
+
+	if (header[0] != BOARD_VERSION)
+		return "unbekannte Version oder Byte-Reihenfolge";
+
+	uint32_t flags = header[1];
+
+	if (flags & ~(BOARD_GRAPH | BOARD_WIDE))
+		return "unbekannte Flags";
+
+	reader.wide = flags & BOARD_WIDE;
+
+	// Groesse, Roboterfeld, Roboterladung, Anzahl
+	if (!reader.read(header, 4))
+		return "unerwartetes Dateiende";
+
+	uint32_t size = header[0], count = header[3];
+
+	if (size == 0 || size > MAX_BOARD_SIZE)
+		return "ungueltige Groesse";
+
+	if (header[1] >= size * size)
+		return "Roboter ausserhalb des Spielfelds";
+
+	if (count > size * size)
+		return "zu viele Batterien";
+
+	// Felder und Ladungen der Batterien und ggf. die Anzahl der Knoten
+	// muessen in der Datei stehen, bevor das Spielfeld angelegt wird
+	if (!reader.has(2 * (size_t)count + ((flags & BOARD_GRAPH) ? 1 : 0)))
+		return "unerwartetes Dateiende";
+
+	initMap(map, size);
+
+	map.robot = { header[1], header[2] };
+
+	map.batteries.resize(count);
+	map.charges.resize(count);
+
+	if (!reader.read(map.batteries.data(), count) || !reader.read(map.charges.data(), count))
+		return "unerwartetes Dateiende";
+
+	for (uint32_t id = 0; id < count; id++)
+	{
+		uint32_t position = map.batteries[id];
+
+		if (position >= map.area)
+			return "Batterie ausserhalb des Spielfelds";
+
+		if (map.grid[position] != NO_BATTERY)
+			return "Feld doppelt belegt";
+
+		map.grid[position] = id;
+	}
+
+	if (flags & BOARD_GRAPH)
+	{
+		initGraph(map);
+
+		adjacency_t &adjacency = map.adjacency;
+		uint32_t nodes = adjacency.count;
+
+		if (!reader.read(&count, 1))
+			return "unerwartetes Dateiende";
+
+		if (count != nodes)
+			return "Adjazenzmatrix passt nicht zum Spielfeld";
+
+		if (!reader.has((size_t)nodes * (nodes + 1)))
+			return "unerwartetes Dateiende";
+
+		for (uint32_t u = 0; u < nodes; u++)
+		{
+			for (uint32_t v = u; v < nodes; v++)
+			{
+				// Laenge (0 = kein Pfad), verlaengerte Laenge (0 = nicht verlaengerbar)
+				uint32_t entry[2];
+				if (!reader.read(entry, 2))
+					return "unerwartetes Dateiende";
+
+				edge_t edge = { entry[0] != 0, entry[1] != 0, entry[0], entry[1], NO_PATH };
+
+				adjacency.edges[u * nodes + v] = edge;
+				adjacency.edges[v * nodes + u] = edge;
+			}
+		}
+	}
+
+	if (reader.pos != reader.size)
+		return "Daten hinter dem Spielfeld";
+
+	return nullptr;
+}
+
+// Schreibt das Spielfeld im Binaerformat. Die Batterien werden wie bei
+// readBoard nach Feld sortiert, damit die IDs zur Adjazenzmatrix passen;
+// graph berechnet diese mit parseGraph und legt sie mit ab.
+bool writeBinaryBoard(const map_t &map, const std::string &path, bool graph, unsigned threads)
+{
+	map_t board;
+	initMap(board, map.size);
+	board.robot = map.robot;
+
+	for (uint32_t position = 0; position < map.area; position++)
+		if (map.grid[position] != NO_BATTERY)
+			addBattery(board, position, map.charges[map.grid[position]]);
+
+	if (graph)
+		parseGraph(board, threads);
+
+	std::vector<uint32_t> values = { board.size, board.robot.position, board.robot.charge,
+		(uint32_t)board.batteries.size() };
+
+	values.insert(values.end(), board.batteries.begin(), board.batteries.end());
+	values.insert(values.end(), board.charges.begin(), board.charges.end());
+
+	if (graph)
+	{
+		const adjacency_t &adjacency = board.adjacency;
+		values.push_back(adjacency.count);
+
+		for (uint32_t u = 0; u < adjacency.count; u++)
+		{
+			for (uint32_t v = u; v < adjacency.count; v++)
+			{
+				const edge_t &edge = adjacency.edges[u * adjacency.count + v];
+
+				values.push_back(edge.available ? edge.length : 0);
+				values.push_back(edge.available && edge.extendable ? edge.extendedLength : 0);
+			}
+		}
+	}
+
+	// 16 Bit reichen fast immer und halbieren die Datei
+	bool wide = *std::max_element(values.begin(), values.end()) > UINT16_MAX;
+
+	uint16_t header[2] = { (uint16_t)BOARD_VERSION, (uint16_t)((graph ? BOARD_GRAPH : 0) | (wide ? BOARD_WIDE : 0)) };
+
+	std::vector<char> data(BOARD_MAGIC, BOARD_MAGIC + sizeof(BOARD_MAGIC));
+	data.insert(data.end(), (const char*)header, (const char*)(header + 2));
+
+	if (wide)
+		data.insert(data.end(), (const char*)values.data(), (const char*)(values.data() + values.size()));
+	else
+	{
+		std::vector<uint16_t> narrow(values.begin(), values.end());
+		data.insert(data.end(), (const char*)narrow.data(), (const char*)(narrow.data() + narrow.size()));
+	}
+
+	FILE *file = std::fopen(path.c_str(), "wb");
+
+	if (!file)
+		return false;
+
+	bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+
+	return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "global.hpp"
+
+// Binaeres Dateiformat fuer Spielfelder (Endung .srb). Nach der Kennung
+// "SRLB" folgen Version und Flags als uint16_t, danach alle Werte als
+// uint16_t oder mit BOARD_WIDE als uint32_t, jeweils in der
+// Byte-Reihenfolge des Rechners (eine falsche faellt an der Version auf):
+//
+//   Groesse, Roboterfeld, Roboterladung, Anzahl
+//   Anzahl Felder der Batterien (nach Feld sortiert, Index = ID)
+//   Anzahl Ladungen der Batterien
+//
+// Mit BOARD_GRAPH folgen die Anzahl der Knoten (wie bei parseGraph) und
+// fuer jedes Paar u <= v die Laenge (0 = kein Pfad) und die verlaengerte
+// Laenge (0 = nicht verlaengerbar) der Kante. Die Felder der Pfade werden
+// nicht gespeichert, getPath berechnet sie bei Bedarf. Passen sie nicht zu
+// den gespeicherten Laengen, endet solveBoard mit Unknown und einem Fehler.
+
+/**************************
+ *    Globale Konstanten   *
+ **************************/
+
+const uint32_t BOARD_VERSION = 1;
+const uint32_t BOARD_GRAPH = 1; // Adjazenzmatrix enthalten
+const uint32_t BOARD_WIDE = 2;  // Werte mit 32 statt 16 Bit
+
+/***************************************
+ *    Globale Methodendeklarationen    *
+ ***************************************/
+
+std::string boardText(const map_t &map);
+bool writeBoard(const map_t &map, const std::string &path, bool graph = false, unsigned threads = 0);
+
+bool isBinaryPath(const std::string &path);
+bool isBinaryBoard(const std::vector<char> &data);
+const char* readBinaryBoard(const std::vector<char> &data, map_t &map);
+bool writeBinaryBoard(const map_t &map, const std::string &path, bool graph, unsigned threads = 0);
@@ -10,6 +10,7 @@
 #include <iostream>
 
 #include "global.hpp"
+#include "board.hpp"
 
 /********************
  *    Konstanten    *
@@ -63,7 +64,7 @@ static double calculateDeltaLength(double size, double density, double length)
 
 static std::vector<uint32_t> batteryBFS(uint32_t start, uint32_t end, map_t &map)
 {
-	if (start == end && map.adjacency[start][end]->available)
+	if (start == end && getEdge(map, nodeOf(map, start), nodeOf(map, end)).available)
 		return { end };
 
 	std::queue<uint32_t> queue;
@@ -82,20 +83,24 @@ static std::vector<uint32_t> batteryBFS(uint32_t start, uint32_t end, map_t &map
 
 		visited[u] = true;
 
-		for (auto v : map.adjacency[u])
+		const edge_t *row = getRow(map, nodeOf(map, u));
+
+		for (uint32_t node = 0; node < map.adjacency.count; node++)
 		{
-			if (!v.second->available)
+			if (!row[node].available)
 				continue;
 
-			if (visited[v.first])
+			uint32_t v = map.adjacency.nodes[node];
+
+			if (visited[v])
 				continue;
 
 			// Pfad soll nur ueber Batterien gehen abgesehen vom Start und Ziel
-			if (v.first != start && v.first != end && map.batteries.find(v.first) == map.batteries.end())
+			if (v != start && v != end && map.grid[v] == NO_BATTERY)
 				continue;
 
-			parent[v.first] = u;
-			queue.push(v.first);
+			parent[v] = u;
+			queue.push(v);
 		}
 	}
 
@@ -118,8 +123,7 @@ static std::vector<uint32_t> batteryBFS(uint32_t start, uint32_t end, map_t &map
 map_t generateConfig(difficulty_t difficulty)
 {
 	map_t map;
-	map.size = difficulty.size;
-	map.area = map.size * map.size;
+	initMap(map, difficulty.size);
 
 	size_t batteryCount = (size_t)std::round((double)map.area * difficulty.density);
 	size_t pathLength = (size_t)std::round((double)batteryCount * difficulty.length);
@@ -151,27 +155,14 @@ map_t generateConfig(difficulty_t difficulty)
 	while(batteryCount--)
 	{
 		uint32_t battery = getRandom();
-		map.batteries[battery] = 0;
+		addBattery(map, battery, 0);
 		batteryCounter[battery] = 0;
 	}
 
+	// Das Ziel wird als zusaetzlicher Knoten aufgenommen,
+	// falls es keine Batterie ist
 	map.robot.position = startNode;
-	parseGraph(map);
-
-	if (map.batteries.find(goalNode) == map.batteries.end())
-	{
-		point_t goalPoint = decode(goalNode, map.size);
-		for (auto battery : map.batteries)
-		{
-			auto path = findPath(decode(battery.first, map.size), goalPoint, map);
-			map.adjacency[battery.first][goalNode] = path;
-			map.adjacency[goalNode][battery.first] = path;
-		}
-
-		auto path = findPath(decode(startNode, map.size), goalPoint, map);
-		map.adjacency[startNode][goalNode] = path;
-		map.adjacency[goalNode][startNode] = path;
-	}
+	parseGraph(map, 0, { goalNode });
 	
 	// Gibt die am wenigsten besuchte Batterie zurueck
 	std::function<uint32_t()> getBattery = [&batteryCounter](){
@@ -202,25 +193,26 @@ map_t generateConfig(difficulty_t difficulty)
 
 		for (auto battery : batteryPath)
 		{
-			auto path = map.adjacency[map.robot.position][battery];
-			if (!path->available)
+			const edge_t &path = getEdge(map, nodeOf(map, map.robot.position), nodeOf(map, battery));
+			if (!path.available)
 				break;
 
-			uint32_t distance = path->length;
+			uint32_t distance = path.length;
 			// Zufaellig kuerzesten oder laengeren Pfad
 			// zwischen den Punkten waehlen
-			if (path->extendable && std::rand() % 10 > 7)
+			if (path.extendable && std::rand() % 10 > 7)
 				// Zufaellige Verlaengerung zw. 0 und 10 waehlen
-				distance = path->extendedLength + (std::rand() % 6) * 2;
+				distance = path.extendedLength + (std::rand() % 6) * 2;
 
 			// Pfad entlanglaufen (Distanz wird zur Ladung addiert)
 			if (battery == startNode)
 				map.robot.charge += distance;
 			else
 			{
+				uint32_t &charge = map.charges[map.grid[battery]];
 				uint32_t oldRobotCharge = map.robot.charge;
-				map.robot.charge = map.batteries[battery];
-				map.batteries[battery] = oldRobotCharge + distance;
+				map.robot.charge = charge;
+				charge = oldRobotCharge + distance;
 			}
 			
 			map.robot.position = battery;
@@ -288,29 +280,12 @@ difficulty_t solveConstraints(constraint_t constraints, bool debug)
 	return diff;
 }
 
-void writeToFile(map_t &map, std::string path)
+// Gibt das Spielfeld aus und schreibt es (bei .srb im Binaerformat)
+bool writeToFile(map_t &map, std::string path, bool graph)
 {
-	std::ofstream output;
-	output.open(path);
 	std::cout << "Spielsitation:\n"
-			  << "--------------" << std::endl;
-	
-	output << map.size << '\n';
-	std::cout << map.size << '\n';
-	
-	point_t robot = decode(map.robot.position, map.size);
-	output << robot.x + 1 << ',' << robot.y + 1 << ',' << map.robot.charge << '\n';
-	std::cout << robot.x + 1 << ',' << robot.y + 1 << ',' << map.robot.charge << '\n';
-
-	output << map.batteries.size() << '\n';
-	std::cout << map.batteries.size() << '\n';
-	for (auto battery : map.batteries)
-	{
-		point_t pos = decode(battery.first, map.size);
-		output << pos.x + 1 << ',' << pos.y + 1 << ',' << battery.second << '\n';
-		std::cout << pos.x + 1 << ',' << pos.y + 1 << ',' << battery.second << '\n';
-	}
+			  << "--------------" << std::endl
+			  << boardText(map) << std::endl;
 
-	output.close();
-	std::cout << std::endl;
+	return writeBoard(map, path, graph);
 }
@@ -28,4 +28,4 @@ typedef struct difficulty_t
 
 difficulty_t solveConstraints(constraint_t constraints, bool debug);
 map_t generateConfig(difficulty_t difficulty);
-void writeToFile(map_t &map, std::string path);
+bool writeToFile(map_t &map, std::string path, bool graph = false);
@@ -1,6 +1,9 @@
 #include "global.hpp"
 
-#include <queue>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <atomic>
 
 uint32_t encode(point_t p, uint32_t size)
 {
@@ -12,40 +15,265 @@ point_t decode(uint32_t n, uint32_t size)
 	return { (int)(n % size), (int)(n / size) };
 }
 
-void parseGraph(map_t &map)
+// Setzt das Spielfeld auf die angegebene Groesse ohne Batterien zurueck
+void initMap(map_t &map, uint32_t size)
 {
+	map.size = size;
+	map.area = size * size;
+
+	map.batteries.clear();
+	map.charges.clear();
+	map.grid.assign(map.area, NO_BATTERY);
 	map.adjacency = adjacency_t();
-	std::map<uint32_t, uint32_t>::iterator u, v;
-	
-	point_t robot = decode(map.robot.position, map.size);
+}
+
+// Fuegt eine Batterie hinzu und gibt deren ID zurueck
+uint32_t addBattery(map_t &map, uint32_t position, uint32_t charge)
+{
+	uint32_t id = map.batteries.size();
+
+	map.batteries.push_back(position);
+	map.charges.push_back(charge);
+	map.grid[position] = id;
+
+	return id;
+}
+
+// Leert das Bitfeld fuer ein Spielfeld der Groesse size
+void bitboard_t::init(uint32_t size)
+{
+	this->size = size;
+	words = (size + 63) / 64;
+	bits.assign(size * words, 0);
+}
+
+// Nimmt das Feld position (wie bei encode) auf
+void bitboard_t::set(uint32_t position)
+{
+	uint32_t x = position % size, y = position / size;
+	row(y)[x / 64] |= 1ull << (x % 64);
+}
+
+// Anzahl der Threads, die parallelFor fuer count Aufgaben verwendet
+// (mindestens 1). threads = 0 steht fuer die Anzahl der Prozessorkerne.
+unsigned workerCount(size_t count, unsigned threads)
+{
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+
+	if (threads > count)
+		threads = count;
+
+	return std::max(1u, threads);
+}
+
+// Fuehrt task(0, worker) bis task(count - 1, worker) auf einem Pool von
+// workerCount(count, threads) Threads aus. worker ist die Nummer des
+// ausfuehrenden Threads, etwa fuer dessen eigenen Arbeitsspeicher.
+void parallelFor(size_t count, unsigned threads, const std::function<void(size_t, unsigned)> &task)
+{
+	threads = workerCount(count, threads);
+
+	std::atomic<size_t> next(0);
+	auto work = [&next, count, &task](unsigned worker)
+	{
+		size_t i;
+		while ((i = next.fetch_add(1)) < count)
+			task(i, worker);
+	};
+
+	if (threads <= 1)
+	{
+		work(0);
+		return;
+	}
+
+	std::vector<std::thread> pool;
+	for (unsigned i = 1; i < threads; i++)
+		pool.emplace_back(work, i);
+
+	work(0);
+
+	for (auto &thread : pool)
+		thread.join();
+}
+
+// Legt einen Pfad im Pool ab und gibt die zugehoerige Kante zurueck
+static edge_t storePath(adjacency_t &adjacency, path_t path)
+{
+	edge_t edge = { path.available, path.extendable, path.length, path.extendedLength, NO_PATH };
+
+	if (path.available)
+	{
+		edge.path = adjacency.paths.size();
+		adjacency.paths.push_back(std::move(path));
+	}
+
+	return edge;
+}
+
+// Stimmen Verfuegbarkeit und Laengen der beiden Kanten ueberein?
+static bool sameEdge(const edge_t &a, const edge_t &b)
+{
+	if (a.available != b.available)
+		return false;
+
+	if (!a.available)
+		return true;
+
+	if (a.length != b.length || a.extendable != b.extendable)
+		return false;
+
+	return !a.extendable || a.extendedLength == b.extendedLength;
+}
+
+// Wird das Paar (u, v) von der Quelle u aus berechnet? Batterien
+// uebernehmen die Paare mit kleineren IDs und allen anderen Knoten,
+// die uebrigen Knoten nur die Paare untereinander.
+static bool ownsPair(uint32_t u, uint32_t v, uint32_t batteries)
+{
+	if (u < batteries)
+		return v <= u || v >= batteries;
+
+	return v >= batteries && v <= u;
+}
+
+// Legt die Knoten und eine leere Adjazenzmatrix an, ohne Kanten zu
+// berechnen. extra sind weitere Felder, die als Knoten aufgenommen werden.
+void initGraph(map_t &map, const std::vector<uint32_t> &extra)
+{
+	adjacency_t &adjacency = map.adjacency;
+	adjacency = adjacency_t();
+	adjacency.index.assign(map.area, NO_NODE);
 
-	for (u = map.batteries.begin(); u != map.batteries.end(); ++u)
+	std::vector<uint32_t> nodes = map.batteries;
+	nodes.push_back(map.robot.position);
+	nodes.insert(nodes.end(), extra.begin(), extra.end());
+
+	for (uint32_t position : nodes)
+	{
+		if (adjacency.index[position] != NO_NODE)
+			continue;
+
+		adjacency.index[position] = adjacency.nodes.size();
+		adjacency.nodes.push_back(position);
+	}
+
+	uint32_t count = adjacency.count = adjacency.nodes.size();
+	adjacency.edges.assign(count * count, { false, false, 0, 0, NO_PATH });
+
+	adjacency.free.init(map.size);
+	for (uint32_t position = 0; position < map.area; position++)
+		if (map.grid[position] == NO_BATTERY)
+			adjacency.free.set(position);
+}
+
+// Berechnet die Adjazenzmatrix. extra sind weitere Felder, die als
+// Knoten aufgenommen werden.
+void parseGraph(map_t &map, unsigned threads, const std::vector<uint32_t> &extra)
+{
+	adjacency_t &adjacency = map.adjacency;
+	initGraph(map, extra);
+
+	uint32_t count = adjacency.count;
+
+	uint32_t batteries = map.batteries.size();
+
+	// Jedes ungeordnete Paar wird nur einmal berechnet (siehe ownsPair)
+	std::vector<std::vector<path_t>> paths(count);
+
+	adjacency.buffers.resize(workerCount(count, threads));
+
+	// Die Quellen mit den meisten Paaren zuerst verteilen. Eine einzige
+	// BFS je Quelle liefert die kuerzesten Pfade zu allen Zielen.
+	parallelFor(count, threads, [&map, &paths, count, batteries](size_t i, unsigned worker)
+	{
+		uint32_t u = i < batteries ? batteries - 1 - i : i;
+		point_t pU = decode(map.adjacency.nodes[u], map.size);
+
+		bfs_buffer_t &buffer = map.adjacency.buffers[worker];
+		const std::vector<uint32_t> &distance = BFSAll(pU, map, buffer);
+
+		for (uint32_t v = 0; v < count; v++)
+		{
+			if (!ownsPair(u, v, batteries))
+				continue;
+
+			point_t pV = decode(map.adjacency.nodes[v], map.size);
+
+			if (v == u)
+				paths[u].push_back(findPath(pU, pU, map, buffer));
+			else
+				paths[u].push_back(completePath(pU, pV, tracePath(distance, pU, pV, map), map, buffer));
+		}
+	});
+
+	for (uint32_t u = 0; u < count; u++)
 	{
-		point_t pU = decode(u->first, map.size);
-		map.adjacency[u->first] = std::map<uint32_t, std::shared_ptr<path_t>>();
-		
-		for (v = map.batteries.begin(); v != map.batteries.end(); ++v)
+		size_t k = 0;
+
+		for (uint32_t v = 0; v < count; v++)
 		{
-			point_t pV = decode(v->first, map.size);
-			
-			if (map.adjacency.find(v->first) == map.adjacency.end())
-				map.adjacency[v->first] = std::map<uint32_t, std::shared_ptr<path_t>>();
-
-			auto path = findPath(pU, pV, map);
-			map.adjacency[u->first][v->first] = path;
-			map.adjacency[v->first][u->first] = path;
+			if (!ownsPair(u, v, batteries))
+				continue;
+
+			edge_t edge = storePath(adjacency, std::move(paths[u][k++]));
+			adjacency.edges[u * count + v] = edge;
+			adjacency.edges[v * count + u] = edge;
 		}
+	}
+}
+
+// Knoten des Feldes (oder NO_NODE)
+uint32_t nodeOf(map_t &map, uint32_t position)
+{
+	return map.adjacency.index[position];
+}
+
+// Gibt alle Kanten vom Knoten u aus zurueck
+const edge_t* getRow(map_t &map, uint32_t u)
+{
+	adjacency_t &adjacency = map.adjacency;
+	return &adjacency.edges[u * adjacency.count];
+}
+
+// Kante von u nach v; aus einer Binaerdatei ggf. ohne Felder
+const edge_t& getEdge(map_t &map, uint32_t u, uint32_t v)
+{
+	return getRow(map, u)[v];
+}
+
+// Felder des Pfades von u nach v; der Zeiger ist nur bis zum naechsten
+// Aufruf gueltig. nullptr, wenn der Pfad nicht zu den Laengen aus einer
+// .srb-Datei passt.
+const path_t* getPath(map_t &map, uint32_t u, uint32_t v)
+{
+	adjacency_t &adjacency = map.adjacency;
+	edge_t &edge = adjacency.edges[u * adjacency.count + v];
+
+	if (edge.path == NO_PATH)
+	{
+		point_t pU = decode(adjacency.nodes[u], map.size);
+		point_t pV = decode(adjacency.nodes[v], map.size);
+		// Nach dem Einlesen einer .srb-Datei gibt es noch keinen Puffer
+		if (adjacency.buffers.empty())
+			adjacency.buffers.resize(1);
+
+		edge_t found = storePath(adjacency, findPath(pU, pV, map, adjacency.buffers[0]));
 
-		auto path = findPath(pU, robot, map);
-		map.adjacency[u->first][map.robot.position] = path;
-		map.adjacency[map.robot.position][u->first] = path;
+		// Laengen aus einer .srb-Datei werden beim Einlesen uebernommen,
+		// ohne die Pfade zu suchen. Passen sie nicht zum Pfad, hat die
+		// Suche mit falschen Werten gerechnet und der Weg ist ungueltig.
+		if (!sameEdge(edge, found))
+			return nullptr;
+
+		edge.path = found.path;
 	}
 
-	auto path = findPath(robot, robot, map);
-	map.adjacency[map.robot.position][map.robot.position] = path;
+	return &adjacency.paths[edge.path];
 }
 
-std::shared_ptr<path_t> findPath(point_t start, point_t end, map_t &map)
+path_t findPath(point_t start, point_t end, map_t &map, bfs_buffer_t &buffer)
 {	
 	std::vector<point_t> shortest;
 	if (start == end) // Pfad zur selben Batterie finden
@@ -58,7 +286,7 @@ std::shared_ptr<path_t> findPath(point_t start, point_t end, map_t &map)
 			if (pos.x < 0 || pos.x >= map.size || pos.y < 0 || pos.y >= map.size)
 				continue;
 
-			if (map.batteries.find(encode(start + dir, map.size)) == map.batteries.end())
+			if (map.grid[encode(start + dir, map.size)] == NO_BATTERY)
 			{
 				shortest = { start, start + dir, start };
 				break;
@@ -66,146 +294,299 @@ std::shared_ptr<path_t> findPath(point_t start, point_t end, map_t &map)
 		}
 	}
 	else
-		shortest = BFS(start, end, map, false);
+	{
+		// Liefert den verlaengerbaren Pfad gleich mit
+		std::vector<point_t> extended;
+		BFS(start, end, map, buffer, shortest, extended);
+
+		return completePath(start, end, shortest, map, buffer, &extended);
+	}
 
-	std::shared_ptr<path_t> path = std::make_shared<path_t>();
+	return completePath(start, end, shortest, map, buffer);
+}
 
-	path->available = shortest.size() >= 2;
-	path->shortest = shortest;
-	path->length = shortest.size() - 1;
+// Ergaenzt einen bereits gefundenen kuerzesten Pfad um den verlaengerbaren
+// Pfad. Ist dieser schon bekannt (known), wird keine BFS gebraucht.
+path_t completePath(point_t start, point_t end, std::vector<point_t> shortest, map_t &map, bfs_buffer_t &buffer, const std::vector<point_t> *known)
+{
+	path_t path = {};
 
-	if (!path->available)
+	path.available = shortest.size() >= 2;
+	path.shortest = shortest;
+	path.length = shortest.size() - 1;
+
+	if (!path.available)
 		return path;
-	else if (path->length > 2)
+	else if (path.length > 2)
 	{
-		path->extendable = true;
-		path->extended = path->shortest;
-		path->extendedLength = path->length;
+		path.extendable = true;
+		path.extended = path.shortest;
+		path.extendedLength = path.length;
 		return path;
 	}
 
 	std::vector<point_t> extended;
-	if (start == end)
+	if (known)
+		extended = *known;
+	else
 	{
-		point_t dir = { 0, 1 };
+		std::vector<point_t> direct;
+		BFS(start, end, map, buffer, direct, extended);
+	}
+
+	if (extended.size() < 2)
+		return path;
+
+	path.extendable = true;
+	path.extended = extended;
+	path.extendedLength = extended.size() - 1;
+
+	return path;
+}
+
+// Bereitet eine neue Suche auf einem Spielfeld mit area Feldern vor
+void bfs_buffer_t::begin(uint32_t area)
+{
+	if (mark.size() < area)
+	{
+		mark.assign(area, 0);
+		parent.resize(area);
+		epoch = 0;
+	}
+
+	// Nach einem Ueberlauf waeren alte Marken wieder gueltig
+	if (++epoch == 0)
+	{
+		std::fill(mark.begin(), mark.end(), 0);
+		epoch = 1;
+	}
+
+	queue.clear();
+}
+
+// Breitensuche ueber die Zustaende (Feld, Schritte), wobei die Schritte
+// bei 3 gekappt werden. Ein Feld kann so in bis zu vier Schichten besucht
+// werden und der Weg darf Felder mehrfach betreten. In einem Durchgang
+// ergeben sich der kuerzeste Pfad (erstes Erreichen von goal) und der
+// kuerzeste verlaengerbare Pfad mit mindestens 3 Schritten (goal in
+// Schicht 3), dessen Felder 1 und 2 frei sind und sich zum Hin- und
+// Herlaufen eignen. Das gilt auch fuer start == goal. Die Pfade laufen
+// von goal nach start und sind leer, wenn es sie nicht gibt.
+void BFS(point_t start, point_t goal, map_t &map, bfs_buffer_t &buffer, std::vector<point_t> &shortest, std::vector<point_t> &extended)
+{
+	map.adjacency.searches.add();
+
+	const uint32_t LAYERS = 4;
+	uint32_t area = map.area;
+
+	buffer.begin(LAYERS * area);
+
+	uint32_t nodeStart = encode(start, map.size);
+	uint32_t nodeGoal = encode(goal, map.size);
+
+	shortest.clear();
+	extended.clear();
+
+	buffer.visit(nodeStart, nodeStart);
+	buffer.queue.push_back(nodeStart);
+
+	uint32_t first = UINT32_MAX; // Zustand, in dem goal zuerst erreicht wurde
+
+	// Zustand = Schicht * area + Feld
+	for (size_t head = 0; head < buffer.queue.size(); head++)
+	{
+		uint32_t stateU = buffer.queue[head];
+		uint32_t layer = std::min(stateU / area + 1, LAYERS - 1);
+		point_t u = decode(stateU % area, map.size);
+
+		point_t dir = { 1, 0 };
 		for (int i = 0; i < 4; i++, dir.rotate90())
 		{
-			if (extended.size() > 0)
-				break;
+			point_t v = u + dir;
+			if (v.x < 0 || v.x >= map.size || v.y < 0 || v.y >= map.size) continue;
 
-			point_t middle = start + dir;
-			if (middle.x < 0 || middle.x >= map.size || middle.y < 0 || middle.y >= map.size)
-				continue;
+			uint32_t nodeV = encode(v, map.size);
+			uint32_t stateV = layer * area + nodeV;
+
+			if (buffer.visited(stateV)) continue;
+
+			// Batterien ausser dem Ziel sind nicht begehbar
+			if (nodeV != nodeGoal && map.grid[nodeV] != NO_BATTERY) continue;
 
-			if (map.batteries.find(encode(middle, map.size)) != map.batteries.end())
+			buffer.visit(stateV, stateU);
+
+			// Das Ziel beendet den Pfad
+			if (nodeV != nodeGoal)
+			{
+				buffer.queue.push_back(stateV);
 				continue;
+			}
 
-			for (int j = 0; j < 4; j++, dir.rotate90())
+			if (first == UINT32_MAX)
+				first = stateV;
+
+			if (layer == LAYERS - 1)
 			{
-				point_t last = middle + dir;
-				if (last.x < 0 || last.x >= map.size || last.y < 0 || last.y >= map.size)
-					continue;
-
-				if (map.batteries.find(encode(last, map.size)) == map.batteries.end())
-				{
-					extended = { start, middle, last, middle, start };
-					break;
-				}
+				head = buffer.queue.size();
+				break;
 			}
 		}
 	}
-	else
-		extended = BFS(start, end, map, true);
 
-	if (extended.size() < 2)
-		return path;
+	auto trace = [&](uint32_t state, std::vector<point_t> &path)
+	{
+		for (; state != nodeStart; state = buffer.parent[state])
+			path.push_back(decode(state % area, map.size));
 
-	path->extendable = true;
-	path->extended = extended;
-	path->extendedLength = extended.size() - 1;
+		path.push_back(start);
+	};
 
-	return path;
+	if (first != UINT32_MAX)
+		trace(first, shortest);
+
+	if (buffer.visited((LAYERS - 1) * area + nodeGoal))
+		trace((LAYERS - 1) * area + nodeGoal, extended);
 }
 
-std::vector<point_t> BFS(point_t start, point_t goal, map_t &map, bool extendable)
+// BFS von start zu allen Feldern. Batterien werden erreicht, aber nicht
+// durchquert. Gibt die Entfernung je Feld zurueck (UNREACHED = unerreicht).
+// Es wird immer die ganze Front auf einmal erweitert: Fuer jede Zeile
+// ergeben sich die Nachbarn aus der um ein Bit verschobenen Zeile und
+// den Zeilen darueber und darunter. Nur die Zeilen, in denen die Front
+// liegen kann, werden bearbeitet. Setzt parseGraph voraus.
+const std::vector<uint32_t>& BFSAll(point_t start, map_t &map, bfs_buffer_t &buffer)
 {
-	std::queue<point_t> queue;
-	queue.push(start);
-	
-	std::vector<bool> visited = std::vector<bool>(map.size * map.size);
-	visited[encode(start, map.size)] = true;
+	map.adjacency.searches.add();
+
+	const bitboard_t &free = map.adjacency.free;
+	uint32_t size = map.size, words = free.words;
+
+	std::vector<uint32_t> &distance = buffer.distance;
+	distance.assign(map.area, UNREACHED);
+
+	// Gueltige Bits im letzten Wort einer Zeile
+	uint64_t lastMask = size % 64 ? (1ull << (size % 64)) - 1 : ~0ull;
+
+	// Besuchte Felder, Front und neue Front in einem Speicherblock
+	std::vector<uint64_t> &block = buffer.bits;
+	block.assign(3 * size * words, 0);
 
-	std::map<point_t, point_t> parent;
+	uint64_t *visited = &block[0];
+	uint64_t *front = &block[size * words];
+	uint64_t *next = &block[2 * size * words];
 
-	// Hoechstens zwei zu ignoriererende Kanten
-	std::pair<point_t, point_t> skip1 = { };
-	std::pair<point_t, point_t> skip2 = { };
+	uint32_t position = encode(start, size);
+	uint64_t bit = 1ull << (start.x % 64);
+	visited[start.y * words + start.x / 64] = bit;
+	front[start.y * words + start.x / 64] = bit;
+	distance[position] = 0;
 
-	if (extendable)
+	uint32_t top = start.y, bottom = start.y; // Zeilen mit Front
+
+	for (uint32_t d = 1; top <= bottom; d++)
 	{
-		// Raute ueberprufen
-		point_t parallel = { 0, 1 };
-		point_t diagonal = { 1, 1 };
+		uint32_t first = top > 0 ? top - 1 : 0;
+		uint32_t last = bottom + 1 < size ? bottom + 1 : size - 1;
+
+		uint32_t newTop = size, newBottom = 0;
 
-		for (int i = 0; i < 4; i++, parallel.rotate90(), diagonal.rotate90())
+		for (uint32_t y = first; y <= last; y++)
 		{
-			if (start + parallel == goal)
-			{
-				skip1 = { start, goal };
-				break;
-			}
-			else if (start + parallel * 2 == goal)
+			const uint64_t *f = front + y * words;
+			const uint64_t *above = y > 0 ? f - words : nullptr;
+			const uint64_t *below = y + 1 < size ? f + words : nullptr;
+
+			uint64_t *seen = visited + y * words;
+			uint64_t *n = next + y * words;
+			uint64_t any = 0;
+
+			for (uint32_t i = 0; i < words; i++)
 			{
-				skip1 = { start + parallel, goal };
-				break;
+				// Nachbarn links und rechts, mit Uebertrag zwischen den Woertern
+				uint64_t bits = (f[i] << 1) | (f[i] >> 1);
+				if (i > 0)
+					bits |= f[i - 1] >> 63;
+				if (i + 1 < words)
+					bits |= f[i + 1] << 63;
+
+				if (above)
+					bits |= above[i];
+				if (below)
+					bits |= below[i];
+
+				if (i + 1 == words)
+					bits &= lastMask;
+
+				bits &= ~seen[i];
+				seen[i] |= bits;
+				n[i] = bits;
+				any |= bits;
+
+				for (uint64_t rest = bits; rest; rest &= rest - 1)
+					distance[y * size + i * 64 + __builtin_ctzll(rest)] = d;
 			}
-			else if (start + diagonal == goal)
+
+			if (any)
 			{
-				skip1 = { start + point_t{ diagonal.x, 0 }, goal };
-				skip2 = { start + point_t{ 0, diagonal.y }, goal };
-				break;
+				newTop = std::min(newTop, y);
+				newBottom = y;
 			}
 		}
-	}
-
-	while(!queue.empty())
-	{
-		point_t u = queue.front();
-		queue.pop();
-		if (u == goal)
-			break;
 
-		point_t dir = { 1, 0 };
-		for (int i = 0; i < 4; i++, dir.rotate90())
+		// Batterien beenden den Pfad und bleiben nicht in der Front
+		for (uint32_t y = first; y <= last; y++)
 		{
-			point_t v = u + dir;
-			uint32_t nodeV = encode(v, map.size);
-			
-			std::pair<point_t, point_t> edge = { u, v };
-			if (edge == skip1 || edge == skip2) continue;
-			
-			if (v.x < 0 || v.x >= map.size || v.y < 0 || v.y >= map.size) continue;
-			if (visited[nodeV]) continue;
-			if (v != goal && map.batteries.find(nodeV) != map.batteries.end()) continue; 
-		
-			visited[nodeV] = true;
-			parent[v] = u;
-			queue.push(v);
+			const uint64_t *passable = free.row(y);
+
+			for (uint32_t i = y * words; i < (y + 1) * words; i++)
+				front[i] = next[i] & passable[i - y * words];
 		}
+
+		top = newTop;
+		bottom = newBottom;
 	}
 
+	return distance;
+}
+
+// Liest den Pfad von goal nach start aus dem Ergebnis von BFSAll. Von
+// jedem Feld geht es zu einem freien Nachbarn, der ein Feld naeher am
+// Start liegt; die Nachbarn werden in derselben Reihenfolge wie bei BFS
+// geprueft.
+std::vector<point_t> tracePath(const std::vector<uint32_t> &distance, point_t start, point_t goal, map_t &map)
+{
 	std::vector<point_t> path;
 
-	if (parent.find(goal) == parent.end())
+	uint32_t u = encode(goal, map.size);
+
+	if (distance[u] == UNREACHED)
 		return path;
 
-	point_t u = goal;
-	while(u != start)
+	point_t p = goal;
+	path.push_back(p);
+
+	while (p != start)
 	{
-		path.push_back(u);
-		u = parent[u];
+		uint32_t d = distance[encode(p, map.size)];
+
+		point_t dir = { 1, 0 };
+		for (int i = 0; i < 4; i++, dir.rotate90())
+		{
+			point_t w = p + dir;
+			if (w.x < 0 || w.x >= map.size || w.y < 0 || w.y >= map.size) continue;
+
+			uint32_t nodeW = encode(w, map.size);
+			if (distance[nodeW] + 1 != d) continue;
+
+			// Nur der Start darf auf dem Weg eine Batterie sein
+			if (w != start && map.grid[nodeW] != NO_BATTERY) continue;
+
+			p = w;
+			break;
+		}
+
+		path.push_back(p);
 	}
-	path.push_back(start);
-	
+
 	return path;
 }
@@ -6,6 +6,19 @@
 #include <map>
 #include <cstdlib>
 #include <memory>
+#include <cstdint>
+#include <functional>
+#include <atomic>
+
+/**************************
+ *    Globale Konstanten   *
+ **************************/
+
+const uint32_t NO_BATTERY = UINT32_MAX; // Feld ohne Batterie
+const uint32_t NO_NODE = UINT32_MAX;    // Feld ohne Knoten im Graphen
+const uint32_t NO_PATH = UINT32_MAX;    // Felder der Kante noch nicht berechnet
+const uint32_t UNREACHED = UINT32_MAX;  // Feld von BFSAll nicht erreicht
+const uint32_t MAX_BOARD_SIZE = 1000;   // Groesste einlesbare Seitenlaenge (Beispiele bis 100)
 
 /**************************
  *    Globale typedefs    *
@@ -28,14 +41,96 @@ typedef struct robot_t
 	uint32_t charge;
 } robot_t;
 
-typedef std::map<uint32_t, std::map<uint32_t, std::shared_ptr<path_t>>> adjacency_t;
+// Veraenderlicher Teil einer Spielsituation
+typedef struct state_t
+{
+	robot_t robot;
+	std::vector<uint32_t> charges; // Ladung je Batterie-ID
+} state_t;
+
+// Kante der Adjazenzmatrix; die Felder liegen getrennt in adjacency_t::paths
+typedef struct edge_t
+{
+	bool available;          // Pfad vorhanden?
+	bool extendable;         // Verlaengerbar?
+	uint32_t length;         // Laenge des kuerzesten Pfades
+	uint32_t extendedLength; // Laenge des verlaengerbaren Pfades
+	uint32_t path;           // Index in adjacency_t::paths (oder NO_PATH)
+} edge_t;
+
+// Menge von Feldern als Bitfeld. Jede Zeile belegt words 64-Bit-Woerter,
+// Bit x % 64 im Wort x / 64 steht fuer die Spalte x. So laesst sich eine
+// ganze Zeile mit Shifts und Masken auf einmal bearbeiten.
+typedef struct bitboard_t
+{
+	uint32_t size = 0;          // Spalten und Zeilen
+	uint32_t words = 0;         // Woerter je Zeile
+	std::vector<uint64_t> bits; // size * words Woerter, zeilenweise
+
+	void init(uint32_t size);
+	void set(uint32_t position);
+	uint64_t* row(uint32_t y) { return &bits[y * words]; }
+	const uint64_t* row(uint32_t y) const { return &bits[y * words]; }
+} bitboard_t;
+
+// Zaehler, den mehrere Threads erhoehen duerfen und der sich
+// trotzdem mit dem Spielfeld kopieren laesst
+typedef struct counter_t
+{
+	std::atomic<uint64_t> value { 0 };
+
+	counter_t() = default;
+	counter_t(const counter_t &other) : value(other.value.load()) {}
+	counter_t& operator=(const counter_t &other) { value = other.value.load(); return *this; }
+
+	void add() { value.fetch_add(1, std::memory_order_relaxed); }
+} counter_t;
+
+// Arbeitsspeicher der Breitensuchen, der von allen Aufrufen mit
+// demselben Puffer wiederverwendet wird. Ein Feld gilt als besucht, wenn
+// seine Marke gleich der aktuellen Epoche ist; zu Beginn einer Suche
+// wird daher nur die Epoche erhoeht statt den Speicher neu anzulegen.
+typedef struct bfs_buffer_t
+{
+	std::vector<uint32_t> mark;     // Epoche des letzten Besuchs je Feld
+	std::vector<uint32_t> parent;   // Vorgaenger je Feld, nur gueltig wenn besucht
+	std::vector<uint32_t> queue;    // Warteschlange als Feldnummern
+	std::vector<uint64_t> bits;     // Bitfelder fuer BFSAll
+	std::vector<uint32_t> distance; // Ergebnis von BFSAll
+	uint32_t epoch = 0;
+
+	void begin(uint32_t area);
+	bool visited(uint32_t v) const { return mark[v] == epoch; }
+	void visit(uint32_t v, uint32_t from) { mark[v] = epoch; parent[v] = from; }
+} bfs_buffer_t;
+
+// Dichte Adjazenzmatrix. Die Knoten sind zuerst die Batterien (Knoten = ID),
+// dann die Startposition des Roboters und weitere angeforderte Felder.
+typedef struct adjacency_t
+{
+	uint32_t count = 0;          // Anzahl Knoten
+	std::vector<uint32_t> nodes; // Feld je Knoten
+	std::vector<uint32_t> index; // Knoten je Feld (oder NO_NODE)
+	std::vector<edge_t> edges;   // count * count Kanten, zeilenweise
+	std::vector<path_t> paths;   // Felder der Pfade
+	counter_t searches;          // Ausgefuehrte BFS seit parseGraph
+	bitboard_t free;             // Felder ohne Batterie, fuer BFSAll
+
+	// Puffer der BFS je Thread von parseGraph, getPath nutzt den ersten.
+	// Sie gehoeren zum Spielfeld und werden mit ihm freigegeben.
+	std::vector<bfs_buffer_t> buffers;
+} adjacency_t;
 
 typedef struct map_t
 {
 	uint32_t size, area; // Groesse des Spielfelds
-	std::map<uint32_t, uint32_t> batteries; // Liste der Batterien
+
+	std::vector<uint32_t> batteries; // Position je Batterie-ID
+	std::vector<uint32_t> charges;   // Ladung je Batterie-ID
+	std::vector<uint32_t> grid;      // Batterie-ID je Feld (oder NO_BATTERY)
+
 	robot_t robot;
-	adjacency_t adjacency; // Adjazenzliste
+	adjacency_t adjacency; // Adjazenzmatrix
 } map_t;
 
 /***************************************
@@ -51,6 +146,20 @@ template <typename T> int sgn(T val)
 uint32_t encode(point_t p, uint32_t size);
 point_t decode(uint32_t n, uint32_t size);
 
-void parseGraph(map_t &map);
-std::shared_ptr<path_t> findPath(point_t start, point_t end, map_t &map);
-std::vector<point_t> BFS(point_t start, point_t goal, map_t &map, bool extendable);
+void initMap(map_t &map, uint32_t size);
+uint32_t addBattery(map_t &map, uint32_t position, uint32_t charge);
+
+unsigned workerCount(size_t count, unsigned threads);
+void parallelFor(size_t count, unsigned threads, const std::function<void(size_t, unsigned)> &task);
+
+void initGraph(map_t &map, const std::vector<uint32_t> &extra = {});
+void parseGraph(map_t &map, unsigned threads = 0, const std::vector<uint32_t> &extra = {});
+uint32_t nodeOf(map_t &map, uint32_t position);
+const edge_t* getRow(map_t &map, uint32_t u);
+const edge_t& getEdge(map_t &map, uint32_t u, uint32_t v);
+const path_t* getPath(map_t &map, uint32_t u, uint32_t v);
+path_t findPath(point_t start, point_t end, map_t &map, bfs_buffer_t &buffer);
+path_t completePath(point_t start, point_t end, std::vector<point_t> shortest, map_t &map, bfs_buffer_t &buffer, const std::vector<point_t> *known = nullptr);
+void BFS(point_t start, point_t goal, map_t &map, bfs_buffer_t &buffer, std::vector<point_t> &shortest, std::vector<point_t> &extended);
+const std::vector<uint32_t>& BFSAll(point_t start, map_t &map, bfs_buffer_t &buffer);
+std::vector<point_t> tracePath(const std::vector<uint32_t> &distance, point_t start, point_t goal, map_t &map);
@@ -1,13 +1,20 @@
 #include "solver.hpp"
 #include "generator.hpp" 
+#include "board.hpp"
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <getopt.h>
 #include <random>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
 
 enum Mode {
-	Generate, Solve
+	Generate, Solve, SolveBatch, Convert
 };
 
 struct flags_t
@@ -15,6 +22,15 @@ struct flags_t
 	Mode mode;
 	char* file;
 	bool debug;
+	bool stats; // Statistik als JSON auf stderr
+	bool graph; // Adjazenzmatrix in Binaerdateien ablegen
+
+	// Solver options
+	solve_options_t options;
+
+	// Batch options
+	std::vector<std::string> boards; // Zu loesende Spielfelder
+	unsigned threads = 0;            // Gleichzeitig geloeste Spielfelder bzw. Threads fuer parseGraph (0 = alle Kerne)
 
 	// Generator options
 	constraint_t constraints;
@@ -41,10 +57,219 @@ static struct option longOptions[] =
 	{ "max-length",     required_argument, NULL, 'L' },
 	{ "min-density",    required_argument, NULL, 'b' },
 	{ "max-density",    required_argument, NULL, 'B' },
+	{ "table-size",     required_argument, NULL, 't' },
+	{ "threads",        required_argument, NULL, 'j' },
+	{ "manifest",       required_argument, NULL, 'm' },
+	{ "search-threads", required_argument, NULL, 'p' },
+	{ "heuristic",      required_argument, NULL, 'H' },
+	{ "portfolio",      no_argument,       NULL, 'P' },
+	{ "time-limit",     required_argument, NULL, 'T' },
+	{ "max-nodes",      required_argument, NULL, 'N' },
+	{ "memory-limit",   required_argument, NULL, 'M' },
+	{ "engine",         required_argument, NULL, 'e' },
+	{ "optimal",        no_argument,       NULL, 'O' },
+	{ "stats",          no_argument,       NULL, 'S' },
+	{ "graph",          no_argument,       NULL, 'g' },
 	{ NULL, 0, NULL, 0 }
 };
 
-static std::string shortOptions = "is:d:D:l:L:b:B:";
+static std::string shortOptions = "is:d:D:l:L:b:B:t:j:m:p:H:PT:N:M:e:OSg";
+
+// Fuegt die Spielfelder eines Pfads hinzu. Bei einem Ordner werden
+// alle .txt und .srb Dateien darin in sortierter Reihenfolge genommen.
+static void addBoards(const std::string &path, std::vector<std::string> &boards)
+{
+	namespace fs = std::filesystem;
+
+	if (!fs::is_directory(path))
+	{
+		boards.push_back(path);
+		return;
+	}
+
+	std::vector<std::string> files;
+	for (auto &entry : fs::directory_iterator(path))
+		if (entry.is_regular_file() && (entry.path().extension() == ".txt" || entry.path().extension() == ".srb"))
+			files.push_back(entry.path().string());
+
+	std::sort(files.begin(), files.end());
+	boards.insert(boards.end(), files.begin(), files.end());
+}
+
+// Liest eine Liste von Spielfeldern ein, ein Pfad pro Zeile.
+// Relative Pfade beziehen sich auf den Ordner der Liste,
+// leere Zeilen und Zeilen mit '#' werden uebersprungen.
+static void readManifest(const char *path, std::vector<std::string> &boards)
+{
+	namespace fs = std::filesystem;
+
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cerr << "Liste kann nicht geöffnet werden: " << path << std::endl;
+		exit(-1);
+	}
+
+	fs::path base = fs::path(path).parent_path();
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		fs::path board = line;
+		addBoards((board.is_relative() ? base / board : board).string(), boards);
+	}
+}
+
+// Wandelt den Namen einer Heuristik um
+static Heuristic parseHeuristic(const std::string &name)
+{
+	if (name == "combined")
+		return Combined;
+	if (name == "charge")
+		return ChargeGreedy;
+	if (name == "hamilton")
+		return HamiltonOnly;
+	if (name == "random")
+		return RandomTies;
+
+	std::cerr << "Unbekannte Heuristik: " << name << "\n"
+			  << "Möglich sind 'combined', 'charge', 'hamilton' und 'random'." << std::endl;
+	exit(-1);
+}
+
+// Wandelt den Namen eines Suchverfahrens um
+static Engine parseEngine(const std::string &name)
+{
+	if (name == "bestfirst")
+		return BestFirst;
+	if (name == "dfs")
+		return DepthFirst;
+
+	std::cerr << "Unbekanntes Suchverfahren: " << name << "\n"
+			  << "Möglich sind 'bestfirst' und 'dfs'." << std::endl;
+	exit(-1);
+}
+
+// Gibt einen Loesungsweg im Format der Ausgabe aus
+static void printPath(std::ostream &out, const std::vector<point_t> &path)
+{
+	for (auto point : path)
+		out << "(" << point.x + 1 << "|" << point.y + 1 << ") ";
+}
+
+// Gibt das Ergebnis eines Loesungsvorgangs als JSON-Objekt in einer Zeile aus
+static void printStats(std::ostream &out, const std::string &file, const solve_result_t &result)
+{
+	const char *status[] = { "solved", "unsolvable", "unknown" };
+	const solve_stats_t &stats = result.stats;
+
+	std::string escaped;
+	for (char c : file)
+	{
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		escaped += c;
+	}
+
+	out << "{\"file\":\"" << escaped << "\""
+		<< ",\"status\":\"" << status[result.status] << "\""
+		<< ",\"steps\":" << result.path.size()
+		<< ",\"moves\":" << result.moves
+		<< ",\"expanded\":" << stats.expanded
+		<< ",\"generated\":" << stats.generated
+		<< ",\"dropped\":" << stats.dropped
+		<< ",\"rejected\":" << stats.rejected
+		<< ",\"peakQueue\":" << stats.peakQueue
+		<< ",\"searches\":" << stats.searches
+		<< ",\"seconds\":{\"hamilton\":" << stats.hamiltonSeconds
+		<< ",\"graph\":" << stats.graphSeconds
+		<< ",\"search\":" << stats.searchSeconds
+		<< ",\"path\":" << stats.pathSeconds
+		<< ",\"total\":" << stats.seconds << "}}" << std::endl;
+}
+
+// Loest alle Spielfelder, je ein Spielfeld pro Thread. Pro Spielfeld
+// wird eine Zeile ausgegeben, sobald es fertig ist:
+// Datei <Tab> Status <Tab> Schritte <Tab> Zeit in ms <Tab> Knoten <Tab> Loesungsweg
+// Status ist "geloest", "unloesbar", "unbekannt" (Grenze erreicht) oder "fehler".
+static void solveBatch(const std::vector<std::string> &boards, unsigned threads, bool stats, solve_options_t options)
+{
+	// Die Spielfelder laufen bereits parallel
+	options.threads = 1;
+
+	std::mutex outputMutex;
+	size_t solved = 0, unsolvable = 0, unknown = 0, failed = 0;
+
+	auto begin = std::chrono::steady_clock::now();
+
+	parallelFor(boards.size(), threads, [&](size_t i, unsigned)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		// Fehler erst unter dem Lock ausgeben, damit sie nicht
+		// zwischen die Zeilen anderer Threads geraten
+		map_t board;
+		std::ostringstream errors;
+		bool valid = readBoard(boards[i].c_str(), board, errors);
+
+		solve_result_t result;
+		if (valid)
+			result = solveBoard(board, options);
+
+		// Eine fehlerhafte Adjazenzmatrix faellt erst beim Loesen auf
+		if (result.error)
+		{
+			errors << "Invalid file format: " << boards[i] << ": " << result.error << std::endl;
+			valid = false;
+		}
+
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+		std::lock_guard<std::mutex> lock(outputMutex);
+
+		std::cerr << errors.str();
+		std::cout << boards[i] << '\t';
+		if (!valid)
+		{
+			std::cout << "fehler";
+			failed++;
+		}
+		else if (result.status == Solved)
+		{
+			std::cout << "geloest";
+			solved++;
+		}
+		else if (result.status == Unsolvable)
+		{
+			std::cout << "unloesbar";
+			unsolvable++;
+		}
+		else
+		{
+			std::cout << "unbekannt";
+			unknown++;
+		}
+
+		std::cout << '\t' << result.path.size() << '\t' << ms << '\t' << result.stats.expanded << '\t';
+		printPath(std::cout, result.path);
+		std::cout << std::endl;
+
+		if (stats && valid)
+			printStats(std::cerr, boards[i], result);
+	});
+
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+
+	std::cerr << boards.size() << " Spielfelder in " << ms << " ms: "
+			  << solved << " gelöst, " << unsolvable << " unlösbar, "
+			  << unknown << " unbekannt, " << failed << " fehlerhaft" << std::endl;
+}
 
 int main(int argc, char *argv[])
 {
@@ -65,15 +290,23 @@ int main(int argc, char *argv[])
 		flags.mode = Generate;
 	else if (modeString == "solve")
 		flags.mode = Solve;
+	else if (modeString == "solve-batch")
+		flags.mode = SolveBatch;
+	else if (modeString == "convert")
+		flags.mode = Convert;
 	else
 	{
 		std::cerr << "Unbekannter Modus: " << modeString << "\n"
-				  << "Benutze entweder 'generate' um Spielsituationen zu generieren,\n"
-				  << "            oder 'solve'    um Spielsituationen zu lösen." << std::endl;
+				  << "Benutze entweder 'generate'    um Spielsituationen zu generieren,\n"
+				  << "            oder 'solve'       um Spielsituationen zu lösen,\n"
+				  << "            oder 'solve-batch' um mehrere Spielsituationen zu lösen,\n"
+				  << "            oder 'convert'     um eine Spielsituation in ein anderes Format zu schreiben." << std::endl;
 		exit(-1);
 	}
 
-	flags.file = argv[optind++];
+	// Im Batch-Modus werden die Dateien erst nach den Optionen gesammelt
+	if (flags.mode != SolveBatch)
+		flags.file = argv[optind++];
 
 	char opt;
 	while((opt = getopt_long(argc, argv, shortOptions.c_str(), longOptions, NULL)) != -1)
@@ -82,6 +315,56 @@ int main(int argc, char *argv[])
 		{
 			case 'i':
 				flags.debug = true;
+				flags.options.debug = true;
+				break;
+			case 't': // Groesse der Transpositionstabelle in MiB
+				flags.options.tableSize = std::stoull(optarg) << 20;
+				break;
+			case 'j': // Im Modus solve die Threads fuer parseGraph
+				if (flags.mode == Generate)
+				{
+					std::cerr << "--threads wird beim Generieren nicht unterstützt" << std::endl;
+					exit(-1);
+				}
+
+				flags.threads = std::stoul(optarg);
+				flags.options.threads = flags.threads;
+				break;
+			case 'm':
+				readManifest(optarg, flags.boards);
+				break;
+			case 'p': // Threads fuer die Suche, 0 = alle Kerne
+				flags.options.searchThreads = std::stoul(optarg);
+				break;
+			case 'H':
+				flags.options.heuristic = parseHeuristic(optarg);
+				break;
+			case 'P':
+				flags.options.portfolio = true;
+				break;
+			case 'T': // Zeitgrenze in Sekunden
+				flags.options.timeLimit = std::stod(optarg);
+				break;
+			case 'N':
+				flags.options.maxNodes = std::stoull(optarg);
+				break;
+			// Gesamter Speicher der Suche in MiB: Knoten, Warteschlange und
+			// Transpositionstabelle (hoechstens ein Viertel davon), bei
+			// --portfolio fuer alle Varianten zusammen
+			case 'M':
+				flags.options.memoryLimit = std::stoull(optarg) << 20;
+				break;
+			case 'e':
+				flags.options.engine = parseEngine(optarg);
+				break;
+			case 'O':
+				flags.options.optimal = true;
+				break;
+			case 'S':
+				flags.stats = true;
+				break;
+			case 'g':
+				flags.graph = true;
 				break;
 			case 's':
 				flags.constraints.size = std::stoul(argv[optind]);
@@ -125,6 +408,45 @@ int main(int argc, char *argv[])
 		exit(-1);
 	}
 
+	// Liest die Datei in beliebigem Format und schreibt sie als Text
+	// oder bei der Endung .srb im Binaerformat
+	if (flags.mode == Convert)
+	{
+		if (argc != optind + 1)
+		{
+			std::cerr << "Usage: " << argv[0] << " convert <Eingabe> <Ausgabe> [--graph] [--threads <Anzahl>]" << std::endl;
+			exit(-1);
+		}
+
+		map_t board;
+		if (!readBoard(flags.file, board))
+			exit(-1);
+
+		if (!writeBoard(board, argv[optind], flags.graph, flags.threads))
+		{
+			std::cerr << "Datei kann nicht geschrieben werden: " << argv[optind] << std::endl;
+			exit(-1);
+		}
+
+		return 0;
+	}
+
+	if (flags.mode == SolveBatch)
+	{
+		while (optind < argc)
+			addBoards(argv[optind++], flags.boards);
+
+		if (flags.boards.empty())
+		{
+			std::cerr << "Keine Spielfelder angegeben!" << std::endl;
+			std::cerr << "Usage: " << argv[0] << " solve-batch <Datei|Ordner>... [--manifest <Liste>] [--threads <Anzahl>]" << std::endl;
+			exit(-1);
+		}
+
+		solveBatch(flags.boards, flags.threads, flags.stats, flags.options);
+		return 0;
+	}
+
 	if (!flags.size && argc > optind)
 		flags.constraints.size = std::stoull(argv[optind++]);
 	
@@ -161,23 +483,55 @@ int main(int argc, char *argv[])
 
 		std::cout << "Anzahl Batterien  : " << map.batteries.size() << '\n' << std::endl;
 
-		writeToFile(map, flags.file);
+		if (!writeToFile(map, flags.file, flags.graph))
+		{
+			std::cerr << "Datei kann nicht geschrieben werden: " << flags.file << std::endl;
+			exit(-1);
+		}
 
 		std::cout << "Datei wurde erfolgreich erstellt: " << flags.file << std::endl;
 	}
 	else
 	{
-		std::vector<point_t> path = solveGame(flags.file, flags.debug);
-		
-		if (path.size() == 0)
+		map_t board;
+		if (!readBoard(flags.file, board))
+			exit(-1);
+
+		solve_result_t result = solveBoard(board, flags.options);
+
+		if (result.error)
+		{
+			std::cerr << "Invalid file format: " << flags.file << ": " << result.error << std::endl;
+			exit(-1);
+		}
+
+		if (result.status == Unsolvable)
 			std::cout << "Die Spielsituation ist unlösbar!" << std::endl;
+		else if (result.status == Unknown)
+		{
+			std::cout << "Innerhalb der Grenzen wurde keine Lösung gefunden!\n"
+					  << "Expandierte Knoten: " << result.stats.expanded << '\n'
+					  << "Erzeugte Knoten   : " << result.stats.generated << '\n'
+					  << "Verworfene Knoten : " << result.stats.dropped << '\n'
+					  << "Laufzeit          : " << result.stats.seconds << " s" << std::endl;
+		}
 		else
 		{
 			std::cout << "Lösungsweg:" << std::endl;
-			for (auto point : path)
-				std::cout << "(" << point.x + 1 << "|" << point.y + 1 << ") ";
+			printPath(std::cout, result.path);
 			std::cout << std::endl;
+
+			if (flags.options.optimal)
+			{
+				std::cout << "\nKleinste Anzahl Züge: " << result.moves << '\n'
+						  << "Expandierte Knoten  : " << result.stats.expanded << '\n'
+						  << "Erzeugte Knoten     : " << result.stats.generated << '\n'
+						  << "Laufzeit            : " << result.stats.seconds << " s" << std::endl;
+			}
 		}
+
+		if (flags.stats)
+			printStats(std::cerr, flags.file, result);
 	}
 
 	return 0;
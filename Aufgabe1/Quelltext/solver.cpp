@@ -6,27 +6,33 @@
 #include <fstream>
 #include <iostream>
 #include <functional>
-#include <regex>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <algorithm>
 
 #include "point.h"
 #include "global.hpp"
+#include "transposition.hpp"
+#include "board.hpp"
+#include "../../Gemeinsam/reader.hpp"
 
 /********************
- *     Typedefs     *
+ *    Konstanten    *
  ********************/
 
-typedef struct node_t
-{
-	node_t *prev;
-	node_t *next;
-
-	uint32_t point;
+static const uint32_t ARENA_BLOCK = 1 << 16;  // Knoten pro Block der Arena
+static const size_t BATCH_SIZE = 64;          // Knoten pro Nachricht an einen anderen Thread
+static const uint32_t CLOCK_INTERVAL = 256;   // Expansionen, nach denen die Zeitgrenze geprueft wird
+static const size_t MIN_QUEUE = 1 << 10;      // Kleinste Warteschlange bei begrenztem Speicher
+static const uint32_t SYNC_INTERVAL = 4;      // Expansionen, nach denen die Raenge der Threads abgeglichen werden
 
-	~node_t();
-	
-	int distance(uint32_t p);
-	node_t* find(uint32_t p);
-} node_t;
+/********************
+ *     Typedefs     *
+ ********************/
 
 typedef struct distance_pair_t
 {
@@ -34,126 +40,372 @@ typedef struct distance_pair_t
 	uint32_t distance;
 } distance_pair_t;
 
+struct solver_t;
+
+// Knoten der Suche in der Arena. Gespeichert wird nur der letzte Zug,
+// der Zugverlauf ergibt sich ueber die Elternknoten und die
+// Batterieladungen werden ueber applyMove/undoMove abgeleitet.
 typedef struct worker_t
 {
+	uint32_t parent;      // Referenz auf den Elternknoten (siehe search_t)
+	uint32_t depth;       // Anzahl Zuege seit der Startsituation
+	distance_pair_t move; // Letzter Zug
 	robot_t robot;
-	std::map<uint32_t, uint32_t> batteries;
-	std::vector<distance_pair_t> path;
 	int score;
-	size_t chargeSum;
-	int prevDirection = 0;
+	uint32_t chargeSum;
+	uint32_t remaining;   // Batterien mit Ladung
+	int prevDirection;
+	uint32_t tie;         // Entscheidet bei gleichem Score
+	uint64_t hash;        // Zobrist-Hash des Zustands
 
-	void calculateScore();
-	bool operator<(const worker_t &rhs) const;
-	bool operator==(const worker_t &rhs) const;
+	void calculateScore(const solver_t &solver, Heuristic heuristic, std::mt19937 &random);
 } worker_t;
 
-/*******************************
- *     Statische Variablen     *
- *******************************/
+// Disjunkte Mengen fuer checkClique, je Menge wird die
+// groesste Ladung ihrer Mitglieder gefuehrt
+typedef struct disjoint_set_t
+{
+	std::vector<uint32_t> parent;
+	std::vector<uint32_t> charge;
+
+	void reset(size_t count);
+	uint32_t find(uint32_t u);
+	void unite(uint32_t u, uint32_t v);
+} disjoint_set_t;
+
+// Eintrag der Warteschlange, verweist auf einen Knoten der Suche
+typedef struct queue_entry_t
+{
+	int score;
+	uint32_t tie;
+	uint32_t index;
+	bool regenerate; // Bereits expandierter Knoten, dessen Kinder verworfen wurden
+
+	bool operator<(const queue_entry_t &rhs) const;
+} queue_entry_t;
 
-static size_t totalCharge;      // Gesamtsumme der Batterieladungen
-static node_t *hamiltonCycle; // Hamiltonkreis
+// Gefundene Loesung mit vollstaendigem Zugverlauf
+typedef struct solution_t
+{
+	robot_t robot;
+	std::vector<distance_pair_t> path;
+	uint32_t moves = 0; // Zuege zu Batterien, ohne das Entladen am Ende
+
+	Status status = Unknown;
+	solve_stats_t stats;
+} solution_t;
+
+// Zustand eines Loesungsvorgangs. Jeder Aufruf von solveGame hat
+// einen eigenen, damit mehrere Spielfelder gleichzeitig geloest
+// werden koennen.
+typedef struct solver_t
+{
+	map_t map; // Spielfeld
+	size_t totalCharge = 0; // Gesamtsumme der Batterieladungen
+
+	std::vector<uint32_t> hamiltonCycle; // Hamiltonkreis als Folge von Feldern
+	std::vector<uint32_t> hamiltonIndex; // Stelle je Feld im Hamiltonkreis
+
+	// Erreichbare Knoten je Batterie als (Laenge, Knoten), aufsteigend
+	// nach Laenge, fuer checkClique. Batterie id hat die Eintraege
+	// neighbourStart[id] bis neighbourStart[id + 1] - 1.
+	std::vector<uint32_t> neighbourStart;
+	std::vector<std::pair<uint32_t, uint32_t>> neighbours;
+
+	// Ende der erlaubten Rechenzeit
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+} solver_t;
+
+// Speicher fuer die Knoten eines Suchthreads. Die Knoten liegen in
+// Bloecken fester Groesse und werden nie verschoben, so koennen andere
+// Threads die Elternknoten lesen, waehrend die Arena waechst.
+typedef struct arena_t
+{
+	std::vector<std::unique_ptr<worker_t[]>> blocks;
+	std::vector<uint32_t> released; // Freigegebene Plaetze
+	uint32_t size = 0;
+	uint32_t limit = 0; // Maximale Anzahl Knoten
+
+	void init(uint64_t maxSize);
+	uint32_t push(const worker_t &node);
+	void release(uint32_t index);
+	worker_t &operator[](uint32_t index);
+} arena_t;
+
+// Daten eines Suchthreads. Jeder Thread besitzt die Zustaende, deren
+// Hash auf ihn abgebildet wird, und fuehrt fuer sie eine eigene
+// Warteschlange und Transpositionstabelle (HDA*).
+typedef struct search_thread_t
+{
+	arena_t arena;
+	transposition_t table;
+
+	// Warteschlange als Heap, damit bei begrenztem Speicher
+	// die schlechtesten Eintraege verworfen werden koennen
+	std::vector<queue_entry_t> queue;
+	size_t queueLimit; // 0 = unbegrenzt
+	size_t trimAt;     // Groesse, ab der wieder gekuerzt wird
+
+	// Von anderen Threads erzeugte Knoten, die diesem gehoeren
+	std::mutex inboxMutex;
+	std::atomic<bool> hasMail { false };
+	std::vector<worker_t> inbox;
+	std::vector<worker_t> received;
+
+	// Gesammelte Knoten fuer die anderen Threads
+	std::vector<std::vector<worker_t>> outbox;
+
+	// Einziger veraenderlicher Zustand, der mit moveTo
+	// zum jeweils expandierten Knoten bewegt wird
+	state_t state;
+	uint32_t stateNode;
+	std::vector<uint32_t> chain;
+
+	disjoint_set_t groups; // Gruppen fuer checkClique
+
+	std::vector<worker_t> children; // Zwischenspeicher fuer expandNode
+	std::mt19937 random; // Fuer die Heuristik RandomTies
+
+	// Rang (siehe orderKey) des besten Eintrags der Warteschlange fuer
+	// die anderen Threads (INT64_MIN = leer), siehe searchThread
+	std::atomic<int64_t> top { INT64_MIN };
+	std::atomic<int64_t> mail { INT64_MIN }; // Bester Rang in der inbox
+
+	// Statistik, wird am Ende ueber die Threads zusammengefasst
+	uint64_t rejected = 0;
+	size_t peakQueue = 0;
+} search_thread_t;
+
+// Ebene der Tiefensuche: Knoten und seine noch offenen Nachfolger,
+// absteigend nach Score sortiert
+typedef struct dfs_frame_t
+{
+	worker_t node;
+	std::vector<worker_t> children;
+	size_t next;
+} dfs_frame_t;
+
+// Gemeinsamer Zustand aller Suchthreads. Ein Knoten wird ueber eine
+// Referenz angesprochen, deren obere Bits den Thread und deren
+// untere nodeBits Bits den Index in dessen Arena angeben.
+typedef struct search_t
+{
+	solver_t *solver;
+	solve_options_t *options;
+
+	std::deque<search_thread_t> threads;
+	uint32_t nodeBits;
+
+	std::atomic<uint64_t> pending { 0 }; // Erzeugte, noch nicht abgearbeitete Knoten
+	std::atomic<bool> done { false };
+	std::atomic<bool> limited { false }; // Zeit-, Knoten- oder Speichergrenze erreicht
+	std::atomic<bool> *cancel;           // Abbruch von aussen (Portfolio), optional
 
-static map_t map; // Spielfeld
+	std::atomic<uint64_t> expanded { 0 };
+	std::atomic<uint64_t> generated { 0 };
+	std::atomic<uint64_t> dropped { 0 };
+
+	std::mutex solutionMutex;
+	bool solved = false;
+	solution_t solution;
+
+	uint32_t ref(uint32_t thread, uint32_t index) const;
+	uint32_t index(uint32_t ref) const;
+	worker_t &node(uint32_t ref);
+	uint32_t owner(uint64_t hash) const;
+} search_t;
 
 /*******************************************
  *     Statische Methodendeklarationen     *
  *******************************************/
 
-static node_t* oddHamilton(node_t *start);
-static node_t* evenHamilton(node_t *start);
-static void findHamilton();
+static void oddHamilton(const map_t &map, std::vector<uint32_t> &cycle);
+static void evenHamilton(const map_t &map, std::vector<uint32_t> &cycle);
+static void findHamilton(solver_t &solver);
+static int cycleDistance(const solver_t &solver, uint32_t from, uint32_t to);
 
 static std::vector<uint32_t> batteryBFS(uint32_t start, uint32_t end, worker_t &state);
-static bool checkClique(worker_t &state);
+static void sortNeighbours(solver_t &solver);
+static bool joinGroup(disjoint_set_t &groups, uint32_t id, uint32_t member, uint32_t charge, uint32_t length);
+static bool checkClique(solver_t &solver, search_thread_t &thread);
+
+static void applyMove(const map_t &map, state_t &state, distance_pair_t move);
+static void undoMove(const map_t &map, state_t &state, distance_pair_t move, uint32_t prevPosition);
+static void moveTo(search_t &search, search_thread_t &thread, uint32_t target);
+
+static uint32_t remainingBatteries(const state_t &state);
+static uint64_t hashState(const state_t &state);
+
+static void receiveNode(search_t &search, uint32_t id, const worker_t &node);
+static void sendNode(search_t &search, uint32_t id, const worker_t &node);
+static int64_t orderKey(int score, uint32_t tie);
+static void postBatch(search_thread_t &target, std::vector<worker_t> &batch);
+static void flushNodes(search_t &search, uint32_t id);
+static void readInbox(search_t &search, uint32_t id);
+static void trimQueue(search_t &search, uint32_t id);
+static void foundSolution(search_t &search, solution_t &solution);
+static bool finishSolution(const map_t &map, const worker_t &worker, std::vector<distance_pair_t> &tail);
+static uint32_t maxDistance(const edge_t &edge, uint32_t charge);
+static uint32_t nextDistance(const edge_t &edge, uint32_t distance);
+static worker_t makeChild(const solver_t &solver, const worker_t &worker, uint32_t parent, uint32_t id, uint32_t charge, uint32_t distance, Heuristic heuristic, std::mt19937 &random);
+static void expandNode(solver_t &solver, const state_t &state, const worker_t &worker, uint32_t parent, Heuristic heuristic, std::mt19937 &random, bool variants, std::vector<worker_t> &children);
+static bool nextVariant(search_t &search, const worker_t &node, Heuristic heuristic, std::mt19937 &random, worker_t &variant);
+static uint32_t betterThreads(search_t &search, int64_t rank);
+static void searchThread(search_t &search, uint32_t self);
+
+static solution_t solveConfig(solver_t &solver, solve_options_t &options, std::atomic<bool> *cancel);
+static solution_t solveDepthFirst(solver_t &solver, solve_options_t &options, std::atomic<bool> *cancel);
+static solution_t solvePortfolio(solver_t &solver, solve_options_t &options);
+static std::vector<distance_pair_t> collectMoves(search_t &search, uint32_t ref);
+static size_t tableBudget(const solve_options_t &options);
+static bool constructPath(map_t &map, solution_t &solution, std::vector<point_t> &path);
+static double lapSeconds(std::chrono::steady_clock::time_point &lap);
 
-static worker_t solveConfig(bool debug);
-static std::vector<point_t> constructPath(worker_t &solution);
-
-static void readFile(const char *path);
 
 /**********************************************
  *     Statische Methodenimplementationen     *
  **********************************************/
 
-// Sucht den Punkt im Ring und gibt
-// dessen Distanz zurueck
-int node_t::distance(uint32_t p)
+void disjoint_set_t::reset(size_t count)
 {
-	int best;
+	parent.resize(count);
+	charge.resize(count);
 
-	node_t* current = this;
-	int dist = 0;
-	do
+	for (uint32_t i = 0; i < count; i++)
+		parent[i] = i;
+}
+
+uint32_t disjoint_set_t::find(uint32_t u)
+{
+	while (parent[u] != u)
 	{
-		if (!current->next) break;
-		dist++;
-		current = current->next;
-	} while(current->point != p && current != this);
+		parent[u] = parent[parent[u]]; // Pfadhalbierung
+		u = parent[u];
+	}
 
-	best = dist;
+	return u;
+}
 
-	current = this;
-	dist = 0;
-	do
+// Vereinigt die Mengen von u und v, die Ladung der Menge ist das Maximum
+void disjoint_set_t::unite(uint32_t u, uint32_t v)
+{
+	u = find(u);
+	v = find(v);
+
+	if (u == v)
+		return;
+
+	if (charge[u] < charge[v])
+		charge[u] = charge[v];
+
+	parent[v] = u;
+}
+
+void arena_t::init(uint64_t maxSize)
+{
+	limit = maxSize < UINT32_MAX ? maxSize : UINT32_MAX;
+	size = 0;
+
+	// Die Liste der Bloecke darf nie neu angelegt werden,
+	// da andere Threads gleichzeitig darin lesen
+	blocks.clear();
+	blocks.reserve((limit + ARENA_BLOCK - 1) / ARENA_BLOCK);
+}
+
+// Fuegt einen Knoten hinzu und gibt seinen Index zurueck,
+// UINT32_MAX wenn die Arena voll ist
+uint32_t arena_t::push(const worker_t &node)
+{
+	if (!released.empty())
 	{
-		if (!current->prev) break;
-		dist--;
-		current = current->prev;
-	} while(current->point != p && current != this);
+		uint32_t index = released.back();
+		released.pop_back();
+
+		(*this)[index] = node;
+		return index;
+	}
+
+	if (size >= limit)
+		return UINT32_MAX;
 
-	if (std::abs(dist) < best)
-		best = dist;
+	if (size % ARENA_BLOCK == 0)
+		blocks.emplace_back(new worker_t[ARENA_BLOCK]);
 
-	return best;
+	blocks[size / ARENA_BLOCK][size % ARENA_BLOCK] = node;
+	return size++;
 }
 
-// Schliesst die Luecke im Ring wenn noetig
-node_t::~node_t()
+// Gibt den Platz eines Knotens frei. Nur fuer Blaetter, auf die
+// kein anderer Knoten als Elternknoten verweist.
+void arena_t::release(uint32_t index)
 {
-	if (prev) prev->next = next;
-	if (next) next->prev = prev;
+	released.push_back(index);
 }
 
-// Findet die Node im Ring mit dem angegebenen Wert
-node_t* node_t::find(uint32_t p)
+worker_t &arena_t::operator[](uint32_t index)
 {
-	if (point == p)
-		return this;
+	return blocks[index / ARENA_BLOCK][index % ARENA_BLOCK];
+}
 
-	node_t *start = this;
-	node_t *current = this;
+uint32_t search_t::ref(uint32_t thread, uint32_t index) const
+{
+	return (uint32_t)(((uint64_t)thread << nodeBits) | index);
+}
 
-	do
-	{
-		if (!current->next) break;
-		current = current->next;
-	} while(current != start && current->point != p);
+uint32_t search_t::index(uint32_t ref) const
+{
+	return nodeBits == 32 ? ref : ref & ((1u << nodeBits) - 1);
+}
 
-	return current;
+worker_t &search_t::node(uint32_t ref)
+{
+	if (nodeBits == 32)
+		return threads[0].arena[ref];
+
+	return threads[ref >> nodeBits].arena[ref & ((1u << nodeBits) - 1)];
 }
 
-bool worker_t::operator<(const worker_t &rhs) const
+// Thread, dem ein Zustand gehoert. Die oberen Bits werden genommen,
+// da die unteren schon den Bucket der Transpositionstabelle bestimmen.
+uint32_t search_t::owner(uint64_t hash) const
 {
-	return score < rhs.score;
+	return (hash >> 32) % threads.size();
 }
 
-bool worker_t::operator==(const worker_t &rhs) const
+bool queue_entry_t::operator<(const queue_entry_t &rhs) const
 {
-	return score == rhs.score;
+	if (score != rhs.score)
+		return score < rhs.score;
+
+	return tie < rhs.tie;
 }
 
-void worker_t::calculateScore()
+void worker_t::calculateScore(const solver_t &solver, Heuristic heuristic, std::mt19937 &random)
 {
+	const map_t &map = solver.map;
+
+	// Jede Batterie mit Ladung braucht noch mindestens einen Zug,
+	// die Schranke ist also zulaessig. Da ein Zug hoechstens eine
+	// Batterie leert, ist sie auch konsistent.
+	if (heuristic == Admissible)
+	{
+		score = -(int)(depth + remaining);
+		tie = depth;
+		return;
+	}
+
 	// Entladene Ladung berechnen
-	score = (totalCharge - this->chargeSum) * (map.area / batteries.size());
+	int discharged = (solver.totalCharge - this->chargeSum) * (map.area / map.batteries.size());
+	tie = 0;
 
-	// Hamiltonkreis zur derzeitigen Position rotieren
-	hamiltonCycle = hamiltonCycle->find(this->robot.position);
-	
-	// Abweichung zur letzten Position berechnen
-	int signedDistance = hamiltonCycle->distance(this->path.back().position);
+	if (heuristic == ChargeGreedy)
+	{
+		score = discharged;
+		return;
+	}
+
+	// Abweichung zur letzten Position im Hamiltonkreis berechnen
+	int signedDistance = cycleDistance(solver, this->robot.position, this->move.position);
 	int sign = sgn(signedDistance);
 
 	// Fand ein Richtungswechsel statt?
@@ -165,17 +417,25 @@ void worker_t::calculateScore()
 	}
 
 	// Abweichung von der Punktzahl abziehen
-	score -= std::abs(signedDistance);
+	score = discharged - std::abs(signedDistance);
+
+	if (heuristic == HamiltonOnly)
+	{
+		// Die Ladung entscheidet nur noch bei gleicher Abweichung
+		score = -std::abs(signedDistance);
+		tie = discharged;
+	}
+	else if (heuristic == RandomTies)
+		tie = random();
 }
 
-static node_t* oddHamilton(node_t *start)
+static void oddHamilton(const map_t &map, std::vector<uint32_t> &cycle)
 {
 	std::vector<bool> visited = std::vector<bool>(map.area);
-	visited[start->point] = true;
+	visited[cycle[0]] = true;
 
-	point_t origin = decode(start->point, map.size);
+	point_t origin = decode(cycle[0], map.size);
 	point_t pos = origin;
-	node_t *current = start;
 
 	point_t corner;
 	corner.x = pos.x <= map.size / 2 ? 0 : map.size - 1;
@@ -192,9 +452,9 @@ static node_t* oddHamilton(node_t *start)
 		dir.y = 0;
 
 	size_t count = 1;
-	std::function<void(point_t)> addPoint = [&current, &visited, &count](point_t p)
+	std::function<void(point_t)> addPoint = [&map, &cycle, &visited, &count](point_t p)
 	{
-		current = (current->next = new node_t { current, NULL, encode(p, map.size) });
+		cycle.push_back(encode(p, map.size));
 		visited[encode(p, map.size)] = true;
 		count++;
 	};
@@ -221,7 +481,7 @@ static node_t* oddHamilton(node_t *start)
 	point_t orth = dir; // Orthogonale bilden
 	orth.rotate90();
 
-	std::function<bool(point_t)> bounded = [](point_t p)
+	std::function<bool(point_t)> bounded = [&map](point_t p)
 	{
 		return p.x >= 0 && p.x < map.size && p.y >= 0 && p.y < map.size;
 	};
@@ -275,13 +535,11 @@ static node_t* oddHamilton(node_t *start)
 			continue;
 		}
 	}
-
-	return current;
 }
 
-static node_t* evenHamilton(node_t *start)
+static void evenHamilton(const map_t &map, std::vector<uint32_t> &cycle)
 {
-	point_t pos = decode(start->point, map.size);
+	point_t pos = decode(cycle[0], map.size);
 	point_t origin = pos;
 
 	do
@@ -289,7 +547,7 @@ static node_t* evenHamilton(node_t *start)
 		if(pos.x == 0 && pos.y < map.size - 1)
 		{
 			pos.y += 1;
-			start = (start->next = new node_t { start, NULL, encode(pos, map.size) });
+			cycle.push_back(encode(pos, map.size));
 			continue;
 		}
 
@@ -300,7 +558,7 @@ static node_t* evenHamilton(node_t *start)
 			else
 				pos.y -= 1;
 
-			start = (start->next = new node_t { start, NULL, encode(pos, map.size) });
+			cycle.push_back(encode(pos, map.size));
 			continue;
 		}
 
@@ -311,7 +569,7 @@ static node_t* evenHamilton(node_t *start)
 			else
 				pos.y -= 1;
 
-			start = (start->next = new node_t { start, NULL, encode(pos, map.size) });
+			cycle.push_back(encode(pos, map.size));
 		}
 		else
 		{
@@ -320,217 +578,1100 @@ static node_t* evenHamilton(node_t *start)
 			else
 				pos.y += 1;
 
-			start = (start->next = new node_t { start, NULL, encode(pos, map.size) });
+			cycle.push_back(encode(pos, map.size));
 		}
 
 	} while (pos != origin);
 
 	// Start ist wieder am Anfang, so waere der Anfang
 	// zweimal enthalten
-	start = start->prev;
-	delete start->next;
-	return start;
+	cycle.pop_back();
 }
 
-static void findHamilton()
+static void findHamilton(solver_t &solver)
 {
-	hamiltonCycle = new node_t { NULL, NULL, map.robot.position };
+	const map_t &map = solver.map;
+	std::vector<uint32_t> &hamiltonCycle = solver.hamiltonCycle;
+	std::vector<uint32_t> &hamiltonIndex = solver.hamiltonIndex;
+
+	hamiltonCycle = { map.robot.position };
 
 	if (map.size % 2)
-		hamiltonCycle->prev = oddHamilton(hamiltonCycle);
+		oddHamilton(map, hamiltonCycle);
 	else
-		hamiltonCycle->prev = evenHamilton(hamiltonCycle);
+		evenHamilton(map, hamiltonCycle);
+
+	// Umkehrtabelle fuer Distanzen in konstanter Zeit. Bei ungerader
+	// Groesse kann ein Feld doppelt vorkommen, dann zaehlt das erste.
+	hamiltonIndex.assign(map.area, UINT32_MAX);
+	for (uint32_t i = hamiltonCycle.size(); i > 0; i--)
+		hamiltonIndex[hamiltonCycle[i - 1]] = i - 1;
+}
+
+// Vorzeichenbehaftete Distanz im Hamiltonkreis; positiv in Laufrichtung.
+// Die kuerzere Richtung gewinnt, fuer dasselbe Feld ist es eine volle Runde.
+// Fehlt ein Feld im Kreis, ist es ebenfalls eine volle Runde.
+static int cycleDistance(const solver_t &solver, uint32_t from, uint32_t to)
+{
+	const std::vector<uint32_t> &hamiltonIndex = solver.hamiltonIndex;
+	int length = solver.hamiltonCycle.size();
 
-	hamiltonCycle->prev->next = hamiltonCycle;
+	if (hamiltonIndex[from] == UINT32_MAX || hamiltonIndex[to] == UINT32_MAX)
+		return length;
+
+	int forward = ((int)hamiltonIndex[to] - (int)hamiltonIndex[from] + length) % length;
+	if (forward == 0)
+		forward = length;
+
+	int backward = forward - length;
+	if (backward == 0)
+		backward = -length;
+
+	return -backward < forward ? backward : forward;
+}
+
+// Legt die nach Laenge sortierten Nachbarn der Batterien fuer
+// checkClique an. Setzt parseGraph voraus.
+static void sortNeighbours(solver_t &solver)
+{
+	map_t &map = solver.map;
+	uint32_t batteries = map.batteries.size();
+
+	solver.neighbourStart.assign(batteries + 1, 0);
+	solver.neighbours.clear();
+
+	for (uint32_t id = 0; id < batteries; id++)
+	{
+		const edge_t *row = getRow(map, id);
+		size_t begin = solver.neighbours.size();
+
+		for (uint32_t node = 0; node < map.adjacency.count; node++)
+			if (row[node].available)
+				solver.neighbours.push_back({ row[node].length, node });
+
+		std::sort(solver.neighbours.begin() + begin, solver.neighbours.end());
+		solver.neighbourStart[id + 1] = solver.neighbours.size();
+	}
+}
+
+// Nimmt Batterie id mit der Ladung charge in die Gruppe von member auf,
+// wenn der Weg der Laenge length fuer eine der beiden Ladungen reicht.
+// Gibt zurueck, ob dabei zwei Gruppen vereinigt wurden.
+static bool joinGroup(disjoint_set_t &groups, uint32_t id, uint32_t member, uint32_t charge, uint32_t length)
+{
+	uint32_t other = groups.find(member);
+	if (other == groups.find(id))
+		return false;
+
+	if (length > charge && length > groups.charge[other])
+		return false;
+
+	groups.unite(id, other);
+	return true;
 }
 
 // Testet ob die Batterien in getrennten Gruppen gebuendelt sind.
 // Dies macht naemlich den Zustand unloesbar.
-static bool checkClique(worker_t &state)
+// Eine Batterie gehoert zu einer Gruppe, wenn sie ein Mitglied erreicht
+// und der Weg hoechstens so lang ist wie ihre Ladung oder die groesste
+// Ladung der Gruppe. Die Gruppen werden als disjunkte Mengen gefuehrt,
+// der Roboter bekommt ein eigenes Element hinter den Knoten des Graphen.
+// Die Gruppen werden je Zustand neu aufgebaut, da ein Zug zwei Ladungen
+// aendert und damit eine Gruppe teilen kann, was eine disjunkte Menge
+// nicht rueckgaengig machen kann. Jede Batterie prueft dafuer nur ihre
+// naechsten Nachbarn: Laengere Wege als ihre Ladung und die groesste
+// Ladung aller bisherigen Gruppen koennen nichts mehr vereinigen.
+static bool checkClique(solver_t &solver, search_thread_t &thread)
 {
-	typedef std::pair<uint32_t, std::vector<uint32_t>> clique_t;
-	std::vector<clique_t> cliques = {{state.robot.charge, {state.robot.position}}};
+	map_t &map = solver.map;
+	state_t &state = thread.state;
+	disjoint_set_t &groups = thread.groups;
+
+	uint32_t robot = map.adjacency.count;
+	uint32_t robotNode = nodeOf(map, state.robot.position);
+
+	groups.reset(robot + 1);
+	groups.charge[robot] = state.robot.charge;
+
+	size_t count = 1; // Anzahl Gruppen
+	uint32_t maxCharge = state.robot.charge; // Groesste Ladung der bisherigen Gruppen
 
-	for (auto battery : state.batteries)
+	for (uint32_t id = 0; id < state.charges.size(); id++)
 	{
-		if (battery.second == 0) continue;
+		uint32_t charge = state.charges[id];
 
-		std::vector<int> foundCliques;
+		if (charge == 0) continue;
 
-		for (int i = 0; i < cliques.size(); i++)
+		groups.charge[id] = charge;
+		count++;
+
+		maxCharge = std::max(maxCharge, charge);
+
+		for (uint32_t i = solver.neighbourStart[id]; i < solver.neighbourStart[id + 1]; i++)
 		{
-			for (auto member : cliques[i].second)
-			{
-				auto path = map.adjacency[battery.first][member];
+			uint32_t length = solver.neighbours[i].first;
+			uint32_t node = solver.neighbours[i].second;
 
-				if (path->available)
-				{
-					if (path->length <= battery.second || path->length <= cliques[i].first)
-					{
-						foundCliques.push_back(i);
-						break;
-					}
-				}
-			}
+			if (length > maxCharge)
+				break;
+
+			// Mitglieder sind der Roboter und die geladenen Batterien vor id
+			if (node == robotNode && joinGroup(groups, id, robot, charge, length))
+				count--;
+
+			if (node < id && state.charges[node] > 0 && joinGroup(groups, id, node, charge, length))
+				count--;
 		}
+	}
+
+	return count == 1;
+}
 
-		if (foundCliques.size() > 1) // Gruppen zusammenfuehren
+// Fuehrt einen Zug auf dem Zustand aus: Der Roboter laeuft die Distanz
+// zur Batterie und tauscht seine Restladung mit deren Ladung
+static void applyMove(const map_t &map, state_t &state, distance_pair_t move)
+{
+	uint32_t &battery = state.charges[map.grid[move.position]];
+	uint32_t oldRobotCharge = state.robot.charge - move.distance;
+
+	state.robot.charge = battery;
+	state.robot.position = move.position;
+	battery = oldRobotCharge;
+}
+
+// Macht applyMove rueckgaengig
+static void undoMove(const map_t &map, state_t &state, distance_pair_t move, uint32_t prevPosition)
+{
+	uint32_t &battery = state.charges[map.grid[move.position]];
+	uint32_t oldBatteryCharge = state.robot.charge;
+
+	state.robot.charge = battery + move.distance;
+	state.robot.position = prevPosition;
+	battery = oldBatteryCharge;
+}
+
+// Ueberfuehrt den Zustand des Threads in den Knoten target.
+// Nur die Zuege bis zum gemeinsamen Vorfahren werden zurueckgenommen
+// bzw. ausgefuehrt, statt jedes mal von der Startsituation aus neu
+// aufzubauen. Die Knoten auf dem Weg koennen zu anderen Threads gehoeren.
+static void moveTo(search_t &search, search_thread_t &thread, uint32_t target)
+{
+	const map_t &map = search.solver->map;
+	state_t &state = thread.state;
+	uint32_t &current = thread.stateNode;
+	std::vector<uint32_t> &chain = thread.chain;
+
+	chain.clear();
+
+	// Auf dieselbe Tiefe bringen
+	while (search.node(current).depth > search.node(target).depth)
+	{
+		const worker_t &node = search.node(current);
+		undoMove(map, state, node.move, search.node(node.parent).move.position);
+		current = node.parent;
+	}
+
+	while (search.node(target).depth > search.node(current).depth)
+	{
+		chain.push_back(target);
+		target = search.node(target).parent;
+	}
+
+	// Bis zum gemeinsamen Vorfahren aufsteigen
+	while (current != target)
+	{
+		const worker_t &node = search.node(current);
+		undoMove(map, state, node.move, search.node(node.parent).move.position);
+		current = node.parent;
+
+		chain.push_back(target);
+		target = search.node(target).parent;
+	}
+
+	for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+	{
+		applyMove(map, state, search.node(*it).move);
+		current = *it;
+	}
+}
+
+// Zaehlt die Batterien mit Ladung
+static uint32_t remainingBatteries(const state_t &state)
+{
+	uint32_t count = 0;
+
+	for (auto charge : state.charges)
+		if (charge > 0)
+			count++;
+
+	return count;
+}
+
+// Berechnet den Zobrist-Hash eines Zustands von Grund auf
+static uint64_t hashState(const state_t &state)
+{
+	uint64_t hash = zobristRobot(state.robot.position, state.robot.charge);
+
+	for (uint32_t id = 0; id < state.charges.size(); id++)
+		hash ^= zobristBattery(id, state.charges[id]);
+
+	return hash;
+}
+
+// Nimmt einen Knoten in die Warteschlange des Threads id auf, sofern
+// sein Zustand nicht bereits in gleicher oder geringerer Tiefe
+// erreicht wurde. Fuer einen uebergangenen Knoten wird stattdessen
+// seine naechste Variante verschickt, da sie sonst nie entstuende.
+static void receiveNode(search_t &search, uint32_t id, const worker_t &node)
+{
+	search_thread_t &thread = search.threads[id];
+
+	if (!thread.table.insert(node.hash, node.depth))
+	{
+		worker_t variant;
+		if (nextVariant(search, node, search.options->heuristic, thread.random, variant))
+			sendNode(search, id, variant);
+
+		search.pending--;
+		return;
+	}
+
+	uint32_t index = thread.arena.push(node);
+
+	if (index == UINT32_MAX) // Arena voll, die Suche wird abgebrochen
+	{
+		search.limited = true;
+		search.done = true;
+		search.pending--;
+		return;
+	}
+
+	thread.queue.push_back({ node.score, node.tie, search.ref(id, index), false });
+	std::push_heap(thread.queue.begin(), thread.queue.end());
+
+	thread.peakQueue = std::max(thread.peakQueue, thread.queue.size());
+
+	if (thread.queueLimit && thread.queue.size() > thread.trimAt)
+		trimQueue(search, id);
+}
+
+// Gibt einen vom Thread id erzeugten Knoten an den Thread, dem sein
+// Zustand gehoert. Knoten fuer andere Threads werden gesammelt und
+// gebuendelt verschickt.
+static void sendNode(search_t &search, uint32_t id, const worker_t &node)
+{
+	uint32_t owner = search.owner(node.hash);
+	search.pending++;
+	search.generated++;
+
+	if (owner == id)
+	{
+		receiveNode(search, id, node);
+		return;
+	}
+
+	std::vector<worker_t> &batch = search.threads[id].outbox[owner];
+	batch.push_back(node);
+
+	if (batch.size() < BATCH_SIZE)
+		return;
+
+	postBatch(search.threads[owner], batch);
+}
+
+// Score und tie als eine Zahl, die wie die Warteschlange ordnet
+static int64_t orderKey(int score, uint32_t tie)
+{
+	return (int64_t)score * ((int64_t)1 << 32) + tie;
+}
+
+// Legt die Knoten in die inbox des Threads und leert batch
+static void postBatch(search_thread_t &target, std::vector<worker_t> &batch)
+{
+	int64_t best = INT64_MIN;
+	for (auto &node : batch)
+		best = std::max(best, orderKey(node.score, node.tie));
+
+	std::lock_guard<std::mutex> lock(target.inboxMutex);
+
+	target.inbox.insert(target.inbox.end(), batch.begin(), batch.end());
+	target.mail = std::max(target.mail.load(), best);
+	target.hasMail = true;
+	batch.clear();
+}
+
+// Verschickt alle gesammelten Knoten des Threads id
+static void flushNodes(search_t &search, uint32_t id)
+{
+	for (uint32_t owner = 0; owner < search.threads.size(); owner++)
+	{
+		std::vector<worker_t> &batch = search.threads[id].outbox[owner];
+
+		if (!batch.empty())
+			postBatch(search.threads[owner], batch);
+	}
+}
+
+// Uebernimmt die von anderen Threads geschickten Knoten
+static void readInbox(search_t &search, uint32_t id)
+{
+	search_thread_t &thread = search.threads[id];
+
+	if (!thread.hasMail)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(thread.inboxMutex);
+		thread.received.swap(thread.inbox);
+		thread.mail = INT64_MIN;
+		thread.hasMail = false;
+	}
+
+	for (auto &node : thread.received)
+		receiveNode(search, id, node);
+
+	thread.received.clear();
+}
+
+// Verwirft das schlechteste Viertel der Warteschlange (SMA*-artig).
+// Die verworfenen Blaetter werden aus der Transpositionstabelle und
+// der Arena entfernt, ihre Elternknoten kommen mit dem besten Score
+// der verworfenen Kinder erneut in die Warteschlange. Werden sie
+// wieder expandiert, entstehen die verworfenen Kinder neu, die
+// uebrigen sind noch in der Tabelle und werden uebersprungen. Wie
+// beim Herausnehmen wird fuer jedes verworfene Blatt die naechste
+// Variante erzeugt (siehe expandNode).
+// Eintraege zur Neuerzeugung werden selbst nie verworfen.
+static void trimQueue(search_t &search, uint32_t id)
+{
+	search_thread_t &thread = search.threads[id];
+	std::vector<queue_entry_t> &queue = thread.queue;
+
+	size_t keep = thread.queueLimit * 3 / 4;
+
+	// Die besten keep Eintraege nach vorne
+	std::nth_element(queue.begin(), queue.begin() + keep, queue.end(),
+		[](const queue_entry_t &a, const queue_entry_t &b) { return b < a; });
+
+	std::vector<queue_entry_t> parents;
+	std::vector<worker_t> variants;
+
+	for (size_t i = keep; i < queue.size(); i++)
+	{
+		queue_entry_t entry = queue[i];
+
+		if (entry.regenerate)
 		{
-			clique_t newClique = cliques[foundCliques[0]];
+			queue[keep++] = entry;
+			continue;
+		}
 
-			for (int i = 1; i < foundCliques.size(); i++)
-			{
-				clique_t otherClique = cliques[foundCliques[i]];
-				newClique.second.insert(newClique.second.end(), otherClique.second.begin(), otherClique.second.end());
+		const worker_t &node = search.node(entry.index);
+		parents.push_back({ entry.score, entry.tie, node.parent, true });
+
+		worker_t variant;
+		if (nextVariant(search, node, search.options->heuristic, thread.random, variant))
+			variants.push_back(variant);
+
+		thread.table.erase(node.hash);
+		thread.arena.release(search.index(entry.index));
+
+		search.pending--;
+		search.dropped++;
+	}
+
+	queue.resize(keep);
+
+	// Jeden Elternknoten nur einmal, mit dem besten Score
+	std::sort(parents.begin(), parents.end(), [](const queue_entry_t &a, const queue_entry_t &b)
+	{
+		return a.index != b.index ? a.index < b.index : b < a;
+	});
+
+	for (size_t i = 0; i < parents.size(); i++)
+	{
+		if (i > 0 && parents[i].index == parents[i - 1].index)
+			continue;
+
+		queue.push_back(parents[i]);
+		search.pending++;
+	}
+
+	std::make_heap(queue.begin(), queue.end());
+
+	// Bestehen die Reste vor allem aus Eintraegen zur Neuerzeugung,
+	// nicht sofort wieder kuerzen
+	thread.trimAt = std::max(thread.queueLimit, queue.size() + thread.queueLimit / 4);
+
+	// Erst jetzt, da sendNode die Warteschlange wieder veraendern kann
+	for (auto &variant : variants)
+		sendNode(search, id, variant);
+}
+
+// Haelt die erste gefundene Loesung fest und beendet die Suche
+static void foundSolution(search_t &search, solution_t &solution)
+{
+	std::lock_guard<std::mutex> lock(search.solutionMutex);
 
-				if (newClique.first < otherClique.first)
-					newClique.first = otherClique.first;
+	if (!search.solved)
+	{
+		search.solved = true;
+		search.solution = solution;
+	}
+
+	search.done = true;
+}
+
+// Prueft, ob der Knoten eine Loesung ist: Alle Batterien sind leer und
+// der Roboter kann seine Restladung auf freien Feldern verbrauchen.
+// Die Zuege dafuer werden in tail abgelegt.
+static bool finishSolution(const map_t &map, const worker_t &worker, std::vector<distance_pair_t> &tail)
+{
+	tail.clear();
+
+	if (worker.chargeSum - worker.robot.charge != 0)
+		return false;
+
+	if (worker.robot.charge == 0) // Schon fertig
+		return true;
+
+	bool dechargeable = false;
+	point_t robotPos = decode(worker.robot.position, map.size);
+
+	point_t dir = { 0, 1 };
+	for (int i = 0; i < 4; i++, dir.rotate90())
+	{
+		if (dechargeable)
+			break;
+	
+		point_t middle = robotPos + dir;
+		if (middle.x < 0 || middle.x >= map.size || middle.y < 0 || middle.y >= map.size)
+			continue;
+	
+		// Feld belegt?
+		if (map.grid[encode(middle, map.size)] != NO_BATTERY)
+			continue;
+
+		if (worker.robot.charge < 3)
+		{
+			dechargeable = true;
+			tail.push_back({ encode(middle, map.size), 1});
+			break;
+		}
+	
+		for (int j = 0; j < 4; j++, dir.rotate90())
+		{
+			point_t last = middle + dir;
+			if (last.x < 0 || last.x >= map.size || last.y < 0 || last.y >= map.size)
+				continue;
+	
+			if (map.grid[encode(last, map.size)] == NO_BATTERY)
+			{
+				dechargeable = true;
+				tail.push_back({ encode(middle, map.size), 1});
+				tail.push_back({ encode(last, map.size), 1});
+				break;
 			}
+		}
+	}
+
+	return dechargeable;
+}
+
+// Groesste Weglaenge ueber die Kante, die mit der Ladung moeglich ist
+// (0 = keine). Moeglich sind die Laenge des kuerzesten Pfades und, falls
+// verlaengerbar, die des verlaengerbaren Pfades zuzueglich je 2 Felder.
+static uint32_t maxDistance(const edge_t &edge, uint32_t charge)
+{
+	if (!edge.available || charge < edge.length)
+		return 0;
+
+	if (!edge.extendable || charge < edge.extendedLength)
+		return edge.length;
 
-			newClique.second.push_back(battery.first);
-			if (newClique.first < battery.second)
-				newClique.first = battery.second;
+	return charge - (charge - edge.extendedLength) % 2;
+}
+
+// Naechstkleinere moegliche Weglaenge ueber die Kante (0 = keine)
+static uint32_t nextDistance(const edge_t &edge, uint32_t distance)
+{
+	if (distance <= edge.length)
+		return 0;
+
+	if (distance >= edge.extendedLength + 2)
+		return distance - 2;
+
+	return edge.length;
+}
+
+// Erzeugt das Kind von worker, das mit distance Schritten zur Batterie
+// id laeuft; charge ist deren Ladung im Zustand von worker
+static worker_t makeChild(const solver_t &solver, const worker_t &worker, uint32_t parent, uint32_t id, uint32_t charge, uint32_t distance, Heuristic heuristic, std::mt19937 &random)
+{
+	uint32_t position = solver.map.batteries[id];
+
+	worker_t newWorker = worker;
+	newWorker.hash = worker.hash
+		^ zobristRobot(worker.robot.position, worker.robot.charge)
+		^ zobristBattery(id, charge)
+		^ zobristRobot(position, charge)
+		^ zobristBattery(id, worker.robot.charge - distance);
+	newWorker.parent = parent;
+	newWorker.depth++;
+	newWorker.robot.charge = charge;
+
+	// Die Zielbatterie hatte Ladung und behaelt die Restladung des Roboters
+	if (worker.robot.charge == distance)
+		newWorker.remaining--;
+
+	// Die Ladungsdifferenz abziehen
+	newWorker.chargeSum -= distance;
+
+	newWorker.move = { position, distance };
+	newWorker.calculateScore(solver, heuristic, random);
+
+	// Die alte Position muss fuer die Scoreberechnung
+	// erhalten bleiben
+	newWorker.robot.position = position;
+
+	return newWorker;
+}
+
+// Erzeugt die Nachfolger eines Knotens, dessen Zustand in state
+// vorliegt, parent wird als Elternknoten eingetragen. Die Kinder zu
+// einer Batterie unterscheiden sich nur in der Weglaenge und damit
+// der in ihr verbleibenden Ladung. Mit variants entsteht je Weglaenge
+// ein Kind, sonst nur das mit der groessten. Dieses hat den besten
+// Score seiner Geschwister; die naechste Variante erzeugt nextVariant
+// erst, wenn es aus der Warteschlange genommen oder verworfen wird.
+static void expandNode(solver_t &solver, const state_t &state, const worker_t &worker, uint32_t parent, Heuristic heuristic, std::mt19937 &random, bool variants, std::vector<worker_t> &children)
+{
+	map_t &map = solver.map;
+	children.clear();
+
+	// Nur die Batterien (Knoten 0 bis n - 1) sind moegliche Ziele
+	const edge_t *row = getRow(map, nodeOf(map, worker.robot.position));
+
+	for (uint32_t id = 0; id < map.batteries.size(); id++)
+	{
+		const edge_t &edge = row[id];
+
+		if (state.charges[id] == 0) continue;
+
+		uint32_t distance = maxDistance(edge, worker.robot.charge);
+
+		for (; distance; distance = variants ? nextDistance(edge, distance) : 0)
+			children.push_back(makeChild(solver, worker, parent, id, state.charges[id], distance, heuristic, random));
+	}
+}
+
+// Erzeugt das Geschwister von node mit der naechstkleineren Weglaenge.
+// Gibt false zurueck, wenn node schon die kuerzeste hat.
+static bool nextVariant(search_t &search, const worker_t &node, Heuristic heuristic, std::mt19937 &random, worker_t &variant)
+{
+	if (node.depth == 0)
+		return false;
+
+	map_t &map = search.solver->map;
+	const worker_t &parent = search.node(node.parent);
 
-			uint32_t deleted = 0;
-			for (auto index : foundCliques)
-				cliques.erase(cliques.begin() + index - (deleted++));
+	uint32_t id = map.grid[node.move.position];
+	const edge_t &edge = getRow(map, nodeOf(map, parent.robot.position))[id];
 
+	uint32_t distance = nextDistance(edge, node.move.distance);
+	if (distance == 0)
+		return false;
+
+	variant = makeChild(*search.solver, parent, node.parent, id, node.robot.charge, distance, heuristic, random);
+	return true;
+}
+
+// Anzahl der Warteschlangen und inboxes, deren bester Eintrag
+// vor rank liegt
+static uint32_t betterThreads(search_t &search, int64_t rank)
+{
+	uint32_t count = 0;
 
-			cliques.push_back(newClique);
+	for (auto &other : search.threads)
+		count += (other.top > rank) + (other.mail > rank);
+
+	return count;
+}
+
+// Bestensuche eines Threads ueber die ihm gehoerenden Zustaende.
+// Die Suche endet, wenn eine Loesung gefunden wurde oder kein
+// Thread mehr Knoten hat und keine Knoten mehr unterwegs sind.
+static void searchThread(search_t &search, uint32_t self)
+{
+	map_t &map = search.solver->map;
+	search_thread_t &thread = search.threads[self];
+	bool debug = search.options->debug;
+	uint64_t maxNodes = search.options->maxNodes;
+
+	uint32_t popped = 0;
+	uint32_t sync = 0;
+	bool allowed = false;
+
+	std::vector<distance_pair_t> tail;
+	worker_t variant;
+
+	while (!search.done && !(search.cancel && *search.cancel))
+	{
+		readInbox(search, self);
+
+		thread.top = thread.queue.empty() ? INT64_MIN : orderKey(thread.queue.front().score, thread.queue.front().tie);
+
+		if (thread.queue.empty())
+		{
+			flushNodes(search, self);
+
+			if (search.pending == 0)
+				break;
+
+			std::this_thread::yield();
+			continue;
 		}
-		else if (foundCliques.size() == 1)
+
+		// Jeder Thread expandiert seine eigene Warteschlange (HDA*), aber
+		// wie bei der k-Bestensuche nur, solange sein bester Eintrag unter
+		// den k besten liegt, die Warteschlangen und inboxes aller Threads
+		// melden, mit k = Anzahl der Threads. Ein Thread, dessen gute
+		// Knoten noch unterwegs sind, baut so keine schlechten Teilbaeume
+		// auf. Abgeglichen wird alle SYNC_INTERVAL Expansionen, ein
+		// wartender Thread prueft bei jedem Durchlauf.
+		if (!allowed || sync++ % SYNC_INTERVAL == 0)
+			allowed = betterThreads(search, thread.top) < search.threads.size();
+
+		if (!allowed)
 		{
-			cliques[foundCliques[0]].second.push_back(battery.first);
+			flushNodes(search, self);
+			std::this_thread::yield();
+			continue;
+		}
 
-			if (cliques[foundCliques[0]].first < battery.second)
-				cliques[foundCliques[0]].first = battery.second;
+		// Grenzen pruefen; die Uhr nur gelegentlich, da sie teuer ist
+		if ((maxNodes && search.expanded >= maxNodes)
+			|| (popped++ % CLOCK_INTERVAL == 0 && std::chrono::steady_clock::now() >= search.solver->deadline))
+		{
+			search.limited = true;
+			search.done = true;
+			break;
 		}
-		else
+
+		std::pop_heap(thread.queue.begin(), thread.queue.end());
+		queue_entry_t entry = thread.queue.back();
+		thread.queue.pop_back();
+
+		uint32_t index = entry.index;
+		worker_t worker = search.node(index);
+
+		// Ein Eintrag zur Neuerzeugung ist schon expandiert und gezaehlt,
+		// seine naechste Variante gibt es bereits
+		if (!entry.regenerate)
 		{
-			cliques.push_back({ battery.second, { battery.first }});
+			search.expanded++;
+
+			// Die naechste Variante kommt erst jetzt in die Warteschlange
+			if (nextVariant(search, worker, search.options->heuristic, thread.random, variant))
+				sendNode(search, self, variant);
 		}
-	}
 
-	return cliques.size() == 1;
+		moveTo(search, thread, index);
+
+		if (!checkClique(*search.solver, thread))
+		{
+			thread.rejected++;
+			search.pending--;
+			continue;
+		}
+
+		if (debug)
+			std::printf("Score: %-5i rem. charge: %-5u\n", worker.score, worker.chargeSum);
+
+		if (finishSolution(map, worker, tail))
+		{
+			solution_t solution;
+			solution.robot = worker.robot;
+			solution.path = collectMoves(search, index);
+			solution.moves = worker.depth;
+			solution.path.insert(solution.path.end(), tail.begin(), tail.end());
+
+			foundSolution(search, solution);
+			break;
+		}
+
+		expandNode(*search.solver, thread.state, worker, index, search.options->heuristic, thread.random, false, thread.children);
+
+		for (auto &child : thread.children)
+			sendNode(search, self, child);
+
+		search.pending--;
+
+		// Sofort verschicken, damit gute Kinder anderer Threads beim
+		// Abgleich der Raenge nicht fehlen
+		flushNodes(search, self);
+	}
 }
 
-static worker_t solveConfig(bool debug)
+// Sucht eine Loesung mit options.searchThreads Threads (0 = alle Kerne).
+// Mit einem Thread ist dies die gewoehnliche Bestensuche. Die Suche
+// endet vorzeitig, sobald *cancel gesetzt wird.
+static solution_t solveConfig(solver_t &solver, solve_options_t &options, std::atomic<bool> *cancel)
 {
-	std::priority_queue<worker_t> queue;
-	queue.push({map.robot, map.batteries, {}, 0, totalCharge});
+	if (options.engine == DepthFirst)
+		return solveDepthFirst(solver, options, cancel);
+
+	map_t &map = solver.map;
+	bool debug = options.debug;
+
+	unsigned count = options.searchThreads;
+	if (count == 0)
+		count = std::max(1u, std::thread::hardware_concurrency());
+
+	uint32_t threadBits = 0;
+	while ((1u << threadBits) < count)
+		threadBits++;
+
+	search_t search;
+	search.solver = &solver;
+	search.options = &options;
+	search.nodeBits = 32 - threadBits;
+	search.cancel = cancel;
+
+	std::random_device seed;
+
+	state_t state = { map.robot, map.charges };
+
+	// Die Transpositionstabelle zaehlt zum Speicherbudget
+	size_t table = tableBudget(options);
+	size_t memory = options.memoryLimit ? options.memoryLimit - table : 0;
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		search.threads.emplace_back();
+		search_thread_t &thread = search.threads.back();
+
+		// Bei begrenztem Speicher teilen sich Arena und Warteschlange
+		// das Budget: Die Warteschlange bekommt die Haelfte, wobei jeder
+		// Eintrag auch einen Knoten belegt. Expandierte Knoten koennen
+		// nicht verworfen werden, ist die Arena voll, endet die Suche.
+		size_t budget = memory / count;
+		uint64_t nodes = 1ull << search.nodeBits;
+
+		if (budget && budget / sizeof(worker_t) < nodes)
+			nodes = budget / sizeof(worker_t);
+
+		thread.arena.init(nodes);
+
+		// Bereits erreichte Zustaende, um Transpositionen nicht
+		// mehrfach zu durchsuchen
+		thread.table.init(table / count);
+
+		thread.outbox.resize(count);
+		thread.state = state;
+
+		thread.queueLimit = budget / 2 / (sizeof(worker_t) + sizeof(queue_entry_t));
+		if (budget && thread.queueLimit < MIN_QUEUE)
+			thread.queueLimit = MIN_QUEUE;
+
+		thread.trimAt = thread.queueLimit;
+		thread.random.seed(seed());
+	}
+
+	// Der Startknoten ist sein eigener Elternknoten
+	worker_t root = { 0, 0, { map.robot.position, 0 }, map.robot, 0, (uint32_t)solver.totalCharge, remainingBatteries(state), 0, 0, hashState(state) };
+	uint32_t owner = search.owner(root.hash);
+	root.parent = search.ref(owner, 0);
+
+	search.pending = 1;
+	receiveNode(search, owner, root);
+
+	for (auto &thread : search.threads)
+		thread.stateNode = root.parent;
 
 	if (debug)
 		std::cout << "Iterationen:" << std::endl;
 
-	while(!queue.empty())
+	parallelFor(count, count, [&search](size_t i, unsigned)
 	{
-		worker_t worker = queue.top();
-		queue.pop();
+		searchThread(search, i);
+	});
 
-		if (!checkClique(worker)) continue;
+	if (debug)
+		std::cout << '\n' << std::endl;
 
+	solution_t solution = search.solution;
+
+	if (search.solved)
+		solution.status = Solved;
+	else if (search.limited || (cancel && *cancel))
+		solution.status = Unknown;
+	else
+		solution.status = Unsolvable;
+
+	solution.stats.expanded = search.expanded;
+	solution.stats.generated = search.generated;
+	solution.stats.dropped = search.dropped;
+
+	for (auto &thread : search.threads)
+	{
+		solution.stats.rejected += thread.rejected;
+		solution.stats.peakQueue += thread.peakQueue;
+	}
+
+	return solution;
+}
+
+// Iterativ vertiefende Tiefensuche als Alternative zur Bestensuche.
+// Es gibt nur einen veraenderlichen Zustand, der beim Absteigen mit
+// applyMove und beim Zuruecklaufen mit undoMove veraendert wird. Der
+// Speicher waechst nur mit der Tiefe, die Transpositionstabelle hat
+// eine feste Groesse. Die Nachfolger werden wie in der Bestensuche
+// bewertet und der Reihe nach besucht. Ein Knoten wird abgeschnitten,
+// wenn seine Tiefe zusammen mit den Batterien, die noch Ladung haben,
+// die Grenze uebersteigt (IDA*). Die Grenze steigt auf den kleinsten
+// abgeschnittenen Wert, bis eine Loesung gefunden ist oder nichts mehr
+// abgeschnitten wurde; dann ist der Suchraum erschoepft. Die erste
+// Loesung hat daher die wenigsten Zuege.
+static solution_t solveDepthFirst(solver_t &solver, solve_options_t &options, std::atomic<bool> *cancel)
+{
+	map_t &map = solver.map;
+	bool debug = options.debug;
+
+	search_thread_t thread;
+	thread.state = { map.robot, map.charges };
+	thread.random.seed(std::random_device()());
+
+	worker_t root = { 0, 0, { map.robot.position, 0 }, map.robot, 0, (uint32_t)solver.totalCharge, remainingBatteries(thread.state), 0, 0, hashState(thread.state) };
+
+	std::vector<dfs_frame_t> stack;
+	std::vector<distance_pair_t> tail;
+
+	solution_t solution;
+	solution.status = Unsolvable;
+
+	uint32_t popped = 0;
+	bool limited = false;
+
+	// Knoten mit Nachfolgern sortiert auf den Stapel legen
+	auto push = [&](const worker_t &node)
+	{
+		stack.push_back({ node, {}, 0 });
+		expandNode(solver, thread.state, node, 0, options.heuristic, thread.random, true, stack.back().children);
+
+		std::stable_sort(stack.back().children.begin(), stack.back().children.end(),
+			[](const worker_t &a, const worker_t &b)
+			{
+				return a.score != b.score ? a.score > b.score : a.tie > b.tie;
+			});
+	};
+
+	// Ohne Batterien ist schon der Startzustand eine Loesung
+	if (finishSolution(map, root, tail))
+	{
+		solution.robot = root.robot;
+		solution.path = tail;
+		solution.status = Solved;
+
+		return solution;
+	}
+
+	uint32_t limit = root.remaining;
+
+	while (!limited)
+	{
 		if (debug)
-			std::printf("Score: %-5i rem. charge: %-5lu\n", worker.score, worker.chargeSum);
+			std::cout << "Tiefengrenze: " << limit << std::endl;
+
+		// Die Tabelle gilt nur fuer eine Tiefengrenze
+		thread.table.init(tableBudget(options));
+		thread.table.insert(root.hash, 0);
 
-		if (worker.chargeSum - worker.robot.charge == 0)
+		uint32_t nextLimit = UINT32_MAX;
+		push(root);
+
+		while (!stack.empty())
 		{
-			if (worker.robot.charge == 0)
-				return worker; // Schon fertig
+			if ((options.maxNodes && solution.stats.expanded >= options.maxNodes)
+				|| (cancel && *cancel)
+				|| (popped++ % CLOCK_INTERVAL == 0 && std::chrono::steady_clock::now() >= solver.deadline))
+			{
+				limited = true;
+				break;
+			}
 
-			bool dechargeable = false;
-			point_t robotPos = decode(worker.robot.position, map.size);
+			dfs_frame_t &frame = stack.back();
 
-			point_t dir = { 0, 1 };
-			for (int i = 0; i < 4; i++, dir.rotate90())
+			// Alle Nachfolger besucht, zurueck zum Elternknoten
+			if (frame.next == frame.children.size())
 			{
-				if (dechargeable)
-					break;
-	
-				point_t middle = robotPos + dir;
-				if (middle.x < 0 || middle.x >= map.size || middle.y < 0 || middle.y >= map.size)
-					continue;
-	
-				// Feld belegt?
-				if (map.batteries.find(encode(middle, map.size)) != map.batteries.end())
-					continue;
+				if (stack.size() > 1)
+					undoMove(map, thread.state, frame.node.move, stack[stack.size() - 2].node.robot.position);
 
-				if (worker.robot.charge < 3)
-				{
-					dechargeable = true;
-					worker.path.push_back({ encode(middle, map.size), 1});
-					break;
-				}
-	
-				for (int j = 0; j < 4; j++, dir.rotate90())
-				{
-					point_t last = middle + dir;
-					if (last.x < 0 || last.x >= map.size || last.y < 0 || last.y >= map.size)
-						continue;
-	
-					if (map.batteries.find(encode(last, map.size)) == map.batteries.end())
-					{
-						dechargeable = true;
-						worker.path.push_back({ encode(middle, map.size), 1});
-						worker.path.push_back({ encode(last, map.size), 1});
-						break;
-					}
-				}
+				stack.pop_back();
+				continue;
 			}
 
-			if (dechargeable)
-				return worker;
-		}
+			worker_t node = frame.children[frame.next++];
 
-		for (auto neighbour : map.adjacency[worker.robot.position])
-		{
-			if (!neighbour.second->available) continue;
-			if (neighbour.first == map.robot.position) continue;
-			if (worker.batteries[neighbour.first] == 0) continue;
+			if (!thread.table.insert(node.hash, node.depth))
+				continue;
 
-			size_t min = neighbour.second->length;
-			if (worker.robot.charge < min) continue;
+			solution.stats.expanded++;
+			applyMove(map, thread.state, node.move);
 
-			size_t max = neighbour.second->extendable ?
-					std::max(worker.robot.charge, neighbour.second->extendedLength) : min;
+			bool pruned = !checkClique(solver, thread);
+			solution.stats.rejected += pruned;
 
-			for (uint32_t distance = min; distance <= max; distance += 2)
+			if (!pruned && finishSolution(map, node, tail))
 			{
-				if (worker.robot.charge < distance) break;
+				solution.robot = node.robot;
+				solution.path.clear();
 
-				worker_t newWorker = worker;
+				for (size_t i = 1; i < stack.size(); i++)
+					solution.path.push_back(stack[i].node.move);
 
-				uint32_t oldRobotCharge = newWorker.robot.charge - distance;
-				newWorker.robot.charge = newWorker.batteries[neighbour.first];
-				newWorker.batteries[neighbour.first] = oldRobotCharge;
+				solution.path.push_back(node.move);
+				solution.path.insert(solution.path.end(), tail.begin(), tail.end());
+				solution.moves = node.depth;
+				solution.status = Solved;
 
-				// Die Ladungsdifferenz abziehen
-				newWorker.chargeSum -= distance;
+				return solution;
+			}
 
-				newWorker.path.push_back({ neighbour.first, distance });
-				newWorker.calculateScore();
-				
-				// Die alte Position muss fuer die Scoreberechnung
-				// erhalten bleiben
-				newWorker.robot.position = neighbour.first;
+			if (!pruned && node.depth + node.remaining > limit)
+			{
+				nextLimit = std::min(nextLimit, node.depth + node.remaining);
+				pruned = true;
+			}
 
-				queue.push(newWorker);
+			if (pruned)
+			{
+				undoMove(map, thread.state, node.move, frame.node.robot.position);
+				continue;
 			}
+
+			push(node);
+			solution.stats.generated += stack.back().children.size();
+			solution.stats.peakQueue = std::max<uint64_t>(solution.stats.peakQueue, stack.size());
+		}
+
+		if (nextLimit == UINT32_MAX)
+			break;
+
+		limit = nextLimit;
+
+		// Die naechste Runde beginnt wieder beim Startzustand
+		while (stack.size() > 1)
+		{
+			undoMove(map, thread.state, stack.back().node.move, stack[stack.size() - 2].node.robot.position);
+			stack.pop_back();
 		}
+
+		stack.clear();
 	}
 
-	if (debug)
-		std::cout << '\n' << std::endl;
+	if (limited)
+		solution.status = Unknown;
 
-	return {};
+	return solution;
 }
 
-static std::vector<point_t> constructPath(worker_t &solution)
+// Laesst mehrere Heuristiken gleichzeitig auf demselben Spielfeld
+// suchen. Die erste Variante, die eine Loesung findet oder den Suchraum
+// erschoepft, bricht die anderen ab. Stoesst eine Variante nur an eine
+// Grenze (Unknown), suchen die anderen weiter; ihr Ergebnis zaehlt nur,
+// wenn keine Variante zu einer Antwort kommt.
+static solution_t solvePortfolio(solver_t &solver, solve_options_t &options)
+{
+	std::vector<Heuristic> variants = { Combined, ChargeGreedy, HamiltonOnly, RandomTies };
+	const char *names[] = { "combined", "charge", "hamilton", "random" };
+
+	std::atomic<bool> cancel(false);
+	std::mutex resultMutex;
+	solution_t result;
+	solve_stats_t stats;
+	bool decided = false;
+
+	parallelFor(variants.size(), variants.size(), [&](size_t i, unsigned)
+	{
+		solve_options_t variant = options;
+		variant.heuristic = variants[i];
+		variant.tableSize = options.tableSize / variants.size();
+		variant.memoryLimit = options.memoryLimit / variants.size();
+
+		solution_t solution = solveConfig(solver, variant, &cancel);
+
+		std::lock_guard<std::mutex> lock(resultMutex);
+
+		stats.expanded += solution.stats.expanded;
+		stats.generated += solution.stats.generated;
+		stats.dropped += solution.stats.dropped;
+		stats.rejected += solution.stats.rejected;
+		stats.peakQueue += solution.stats.peakQueue;
+
+		// Abgebrochene Varianten haben kein Ergebnis
+		if (decided)
+			return;
+
+		result = solution;
+
+		if (solution.status == Unknown)
+			return;
+
+		decided = true;
+		cancel = true;
+
+		if (options.debug)
+			std::cout << "Portfolio: Heuristik " << names[variants[i]] << " war zuerst fertig" << std::endl;
+	});
+
+	result.stats = stats;
+	return result;
+}
+
+// Baut den Zugverlauf eines Knotens ueber die Elternknoten auf
+static std::vector<distance_pair_t> collectMoves(search_t &search, uint32_t ref)
+{
+	std::vector<distance_pair_t> moves(search.node(ref).depth);
+
+	for (size_t i = moves.size(); i > 0; i--)
+	{
+		moves[i - 1] = search.node(ref).move;
+		ref = search.node(ref).parent;
+	}
+
+	return moves;
+}
+
+// Bytes fuer die Transpositionstabelle. Bei begrenztem Speicher bekommt
+// sie hoechstens ein Viertel des Budgets, der Rest bleibt fuer die
+// Knoten und die Warteschlange.
+static size_t tableBudget(const solve_options_t &options)
+{
+	if (options.memoryLimit == 0)
+		return options.tableSize;
+
+	return std::min(options.tableSize, options.memoryLimit / 4);
+}
+
+// Sekunden seit lap; lap wird auf jetzt gesetzt
+static double lapSeconds(std::chrono::steady_clock::time_point &lap)
+{
+	auto now = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(now - lap).count();
+
+	lap = now;
+	return seconds;
+}
+
+// Setzt den Weg des Roboters aus den Pfaden der Loesung zusammen. false,
+// wenn ein Pfad nicht zur eingelesenen Adjazenzmatrix passt.
+static bool constructPath(map_t &map, solution_t &solution, std::vector<point_t> &path)
 {
 	// Keine Loesung
 	if (solution.path.size() == 0)
-		return {};
-
-	std::vector<point_t> path;
+		return true;
 
 	for(int i = 0; i < solution.path.size(); i++)
 	{
@@ -553,19 +1694,23 @@ static std::vector<point_t> constructPath(worker_t &solution)
 		point_t pA = decode(nodeA, map.size);
 		point_t pB = decode(nodeB, map.size);
 
-		auto edgePath = map.adjacency[nodeA][nodeB];
+		const path_t *found = getPath(map, nodeOf(map, nodeA), nodeOf(map, nodeB));
+		if (!found)
+			return false;
+
+		const path_t &edgePath = *found;
 		uint32_t distance = solution.path[i].distance;
 
-		if (distance == edgePath->length)
+		if (distance == edgePath.length)
 		{
 			// Kuerzesten Pfad kopieren
 			
 			// Muss der Pfad umgedreht werden
-			if (edgePath->shortest[0] == pA)
-				path.insert(path.end(), edgePath->shortest.begin() + 1, edgePath->shortest.end());
+			if (edgePath.shortest[0] == pA)
+				path.insert(path.end(), edgePath.shortest.begin() + 1, edgePath.shortest.end());
 			else
 				// Pfad rueckwaerts einfuegen
-				path.insert(path.end(), edgePath->shortest.rbegin() + 1, edgePath->shortest.rend());
+				path.insert(path.end(), edgePath.shortest.rbegin() + 1, edgePath.shortest.rend());
 		}
 		else
 		{
@@ -575,18 +1720,18 @@ static std::vector<point_t> constructPath(worker_t &solution)
 			std::vector<point_t> extended;
 			
 			// Noetige Verlaengerung berechnen
-			uint32_t extension = distance - edgePath->extendedLength;
+			uint32_t extension = distance - edgePath.extendedLength;
 
-			size_t end = edgePath->extended.size() - 1;
+			size_t end = edgePath.extended.size() - 1;
 
 			// Verlaengerung zum Pfad hinzufuegen
 			uint32_t current = 0;
 			while(extension > 0)
 			{
-				if (edgePath->extended[0] == pA)
-					extended.push_back(edgePath->extended[1 + current]);
+				if (edgePath.extended[0] == pA)
+					extended.push_back(edgePath.extended[1 + current]);
 				else
-					extended.push_back(edgePath->extended[end - 1 - current]);
+					extended.push_back(edgePath.extended[end - 1 - current]);
 
 				current = (current + 1) % 2;
 				extension--;
@@ -594,10 +1739,10 @@ static std::vector<point_t> constructPath(worker_t &solution)
 			path.insert(path.end(), extended.begin(), extended.end());
 
 			// Restlichen Pfad hinzufuegen
-			if (edgePath->extended[0] == pA)
-				path.insert(path.end(), edgePath->extended.begin() + 1, edgePath->extended.end());
+			if (edgePath.extended[0] == pA)
+				path.insert(path.end(), edgePath.extended.begin() + 1, edgePath.extended.end());
 			else
-				path.insert(path.end(), edgePath->extended.rbegin() + 1, edgePath->extended.rend());
+				path.insert(path.end(), edgePath.extended.rbegin() + 1, edgePath.extended.rend());
 		}
 	}
 	
@@ -619,88 +1764,190 @@ static std::vector<point_t> constructPath(worker_t &solution)
 			path.push_back(decode(solution.robot.position, map.size));
 	}
 
-	return path;
+	return true;
 }
 
-static void readFile(const char *path)
+/*************************************************
+ *     Oeffentliche Methodenimplementationen     *
+ *************************************************/
+
+// Liest das Spielfeld als Text oder im Binaerformat aus der Datei.
+// Gibt false zurueck, wenn die Datei nicht geoeffnet werden kann oder
+// fehlerhaft ist; der Grund wird nach errors geschrieben.
+bool readBoard(const char *path, map_t &map, std::ostream &errors)
 {
-	std::ifstream file(path);
-	std::regex r("\\d+");
+	reader_t reader;
 
-	if (file.is_open())
+	if (!reader.open(path))
 	{
-		std::function<std::string(std::ifstream&)> readLine = [](std::ifstream &file)
-		{
-			std::string line;
-			if (!std::getline(file, line))
-			{
-				std::cerr << "Invalid file format!" << std::endl;
-				exit(-1);
-			}
-			return line;
-		};
-
-		map.size = std::stoi(readLine(file));
-		map.area = map.size * map.size;
-		totalCharge = 0;
+		errors << "Fehlerhafte oder korrupte Datei:  " << path << "!" << std::endl;
+		return false;
+	}
 
-		std::string line = readLine(file);
-		std::sregex_iterator it(line.begin(), line.end(), r);
-		int x = std::stoi((*it)[0]) - 1;
-		int y = std::stoi((*(++it))[0]) - 1;
-		uint32_t c = std::stoi((*(++it))[0]);
-		map.robot = { encode({ x, y }, map.size), c };
-		totalCharge += c;
+	if (isBinaryBoard(reader.data))
+	{
+		const char *error = readBinaryBoard(reader.data, map);
 
-		size_t count = std::stoull(readLine(file));
+		if (error)
+			errors << "Invalid file format: " << path << ": " << error << std::endl;
 
-		while(count--)
-		{
-			std::string line = readLine(file);
-			std::sregex_iterator it(line.begin(), line.end(), r);
-			int x = std::stoi((*it)[0]) - 1;
-			int y = std::stoi((*(++it))[0]) - 1;
-			uint32_t c = std::stoi((*(++it))[0]);
-			map.batteries.insert({ encode({ x, y }, map.size), c });
-			totalCharge += c;
-		}
+		return !error;
 	}
-	else
+
+	// Meldet die fehlerhafte Zeile mit dem Grund
+	std::function<bool(const char *)> fail = [&reader, path, &errors](const char *reason)
 	{
-		std::cerr << "Fehlerhafte oder korrupte Datei:  " << path << "!" << std::endl;
-		exit(-1);
+		errors << "Invalid file format: " << path << ":" << reader.line << ": " << reason << std::endl;
+		return false;
+	};
+
+	// Prueft, ob die Koordinaten auf dem Spielfeld liegen
+	std::function<bool(uint32_t, uint32_t)> inside = [&map](uint32_t x, uint32_t y)
+	{
+		return x >= 1 && x <= map.size && y >= 1 && y <= map.size;
+	};
+
+	std::vector<uint32_t> values;
+
+	if (!reader.readLine(values, 1))
+		return fail(reader.error);
+
+	if (values[0] == 0)
+		return fail("Spielfeld ohne Felder");
+
+	// Begrenzt auch size * size, das sonst in 32 Bit ueberlaufen koennte
+	if (values[0] > MAX_BOARD_SIZE)
+		return fail("Spielfeld zu gross");
+
+	initMap(map, values[0]);
+
+	if (!reader.readLine(values, 3))
+		return fail(reader.error);
+
+	if (!inside(values[0], values[1]))
+		return fail("Roboter ausserhalb des Spielfelds");
+
+	map.robot = { encode({ (int)values[0] - 1, (int)values[1] - 1 }, map.size), values[2] };
+
+	if (!reader.readLine(values, 1))
+		return fail(reader.error);
+
+	size_t count = values[0];
+
+	// Batterien nach Feld sortiert einfuegen, damit die IDs
+	// unabhaengig von der Reihenfolge in der Datei sind
+	std::map<uint32_t, uint32_t> batteries;
+
+	while(count--)
+	{
+		if (!reader.readLine(values, 3))
+			return fail(reader.error);
+
+		if (!inside(values[0], values[1]))
+			return fail("Batterie ausserhalb des Spielfelds");
+
+		uint32_t position = encode({ (int)values[0] - 1, (int)values[1] - 1 }, map.size);
+
+		if (!batteries.insert({ position, values[2] }).second)
+			return fail("Feld doppelt belegt");
 	}
+
+	for (auto battery : batteries)
+		addBattery(map, battery.first, battery.second);
+
+	return true;
 }
 
-/*************************************************
- *     Oeffentliche Methodenimplementationen     *
- *************************************************/
+std::vector<point_t> solveGame(const char* path, solve_options_t options)
+{
+	map_t board;
+
+	if (!readBoard(path, board))
+		exit(-1);
 
-std::vector<point_t> solveGame(const char* path, bool debug)
+	return solveBoard(board, options).path;
+}
+
+std::vector<point_t> solveGame(const map_t &board, solve_options_t options)
+{
+	return solveBoard(board, options).path;
+}
+
+solve_result_t solveBoard(const map_t &board, solve_options_t options)
 {
-	readFile(path);
+	bool debug = options.debug;
+	auto start = std::chrono::steady_clock::now();
+
+	solver_t solver;
+	solver.map = board;
+	solver.totalCharge = board.robot.charge;
 
-	findHamilton();
+	for (auto charge : board.charges)
+		solver.totalCharge += charge;
+
+	// Die erste Loesung ist nur bei einem einzelnen Thread
+	// sicher die mit den wenigsten Zuegen
+	if (options.optimal)
+	{
+		options.heuristic = Admissible;
+		options.searchThreads = 1;
+		options.portfolio = false;
+	}
+
+	if (options.timeLimit > 0)
+		solver.deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(options.timeLimit));
+
+	solve_stats_t stats;
+	auto lap = start;
+
+	findHamilton(solver);
+	stats.hamiltonSeconds = lapSeconds(lap);
 
 	if (debug)
 	{
-		std::cout << "Hamiltonkreis:" << std::endl;
+		const std::vector<uint32_t> &hamiltonCycle = solver.hamiltonCycle;
 
-		node_t *current = hamiltonCycle->next;
+		std::cout << "Hamiltonkreis:" << std::endl;
 
-		std::cout << "X---->" << hamiltonCycle->point << "-->";
+		std::cout << "X---->" << hamiltonCycle.front() << "-->";
 
-		while(current != hamiltonCycle->prev)
-		{
-			std::cout << current->point << "-->";
-			current = current->next;
-		}
+		for (size_t i = 1; i + 1 < hamiltonCycle.size(); i++)
+			std::cout << hamiltonCycle[i] << "-->";
 
-		std::cout << hamiltonCycle->prev->point << "---->X"
+		std::cout << hamiltonCycle.back() << "---->X"
 				  << '\n' <<  std::endl;
 	}
 
-	parseGraph(map);
-	worker_t solution = solveConfig(debug);
-	return constructPath(solution);
+	// Eine Binaerdatei kann die Adjazenzmatrix bereits mitbringen
+	if (solver.map.adjacency.count == 0)
+		parseGraph(solver.map, options.threads);
+	sortNeighbours(solver);
+	stats.graphSeconds = lapSeconds(lap);
+
+	solution_t solution = options.portfolio ?
+		solvePortfolio(solver, options) : solveConfig(solver, options, nullptr);
+	stats.searchSeconds = lapSeconds(lap);
+
+	solve_result_t result;
+	result.status = solution.status;
+	result.moves = solution.moves;
+
+	if (!constructPath(solver.map, solution, result.path))
+	{
+		result.status = Unknown;
+		result.path.clear();
+		result.error = "Adjazenzmatrix passt nicht zum Spielfeld";
+	}
+	stats.pathSeconds = lapSeconds(lap);
+
+	result.stats = solution.stats;
+	result.stats.searches = solver.map.adjacency.searches.value;
+	result.stats.hamiltonSeconds = stats.hamiltonSeconds;
+	result.stats.graphSeconds = stats.graphSeconds;
+	result.stats.searchSeconds = stats.searchSeconds;
+	result.stats.pathSeconds = stats.pathSeconds;
+	result.stats.seconds = std::chrono::duration<double>(lap - start).count();
+
+	return result;
 }
@@ -3,7 +3,86 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <iostream>
 
 #include "point.h"
+#include "global.hpp"
 
-std::vector<point_t> solveGame(const char* path, bool debug);
+// Bewertung der Knoten in der Bestensuche
+enum Heuristic {
+	Combined,     // Entladene Ladung abzueglich der Abweichung vom Hamiltonkreis
+	ChargeGreedy, // Nur die entladene Ladung
+	HamiltonOnly, // Nur die Abweichung vom Hamiltonkreis
+	RandomTies,   // Wie Combined, gleiche Scores in zufaelliger Reihenfolge
+	Admissible    // Zuege plus untere Schranke der restlichen Zuege (A*, siehe optimal)
+};
+
+// Suchverfahren
+enum Engine {
+	BestFirst, // Bestensuche mit Warteschlange (Standard)
+	DepthFirst // Iterativ vertiefende Tiefensuche, Speicher waechst nur mit der Tiefe
+};
+
+// Ausgang eines Loesungsvorgangs
+enum Status {
+	Solved,     // Loesung gefunden
+	Unsolvable, // Suchraum erschoepft, es gibt keine Loesung
+	Unknown     // Abgebrochen, bevor eine Antwort feststand
+};
+
+typedef struct solve_options_t
+{
+	bool debug = false;
+	size_t tableSize = 64 << 20; // Bytes fuer die Transpositionstabelle (0 = aus)
+	unsigned threads = 0;        // Threads fuer parseGraph (0 = alle Kerne)
+	unsigned searchThreads = 1;  // Threads fuer die Suche (0 = alle Kerne)
+	Engine engine = BestFirst;
+	Heuristic heuristic = Combined;
+	bool portfolio = false;      // Alle Heuristiken gleichzeitig, die schnellste gewinnt
+	bool optimal = false;        // Loesung mit den wenigsten Zuegen; ein Thread, ohne Portfolio
+	double timeLimit = 0;        // Sekunden bis zum Abbruch (0 = unbegrenzt)
+	uint64_t maxNodes = 0;       // Expandierte Knoten bis zum Abbruch (0 = unbegrenzt)
+	size_t memoryLimit = 0;      // Bytes fuer Knoten, Warteschlange und Tabelle zusammen (0 = unbegrenzt)
+} solve_options_t;
+
+// Statistik eines Loesungsvorgangs. Die Zaehler werden immer
+// erfasst, da sie kaum Zeit kosten.
+typedef struct solve_stats_t
+{
+	uint64_t expanded = 0;  // Aus der Warteschlange genommene Knoten
+	uint64_t generated = 0; // Erzeugte Knoten
+	uint64_t dropped = 0;   // Wegen der Speichergrenze verworfene Knoten
+	uint64_t rejected = 0;  // Von checkClique als unloesbar erkannte Knoten
+	uint64_t peakQueue = 0; // Groesste Warteschlange (Summe ueber die Threads, Tiefensuche: groesste Tiefe)
+	uint64_t searches = 0;  // Ausgefuehrte BFS
+
+	// Laufzeiten der Abschnitte in Sekunden
+	double hamiltonSeconds = 0; // findHamilton
+	double graphSeconds = 0;    // parseGraph
+	double searchSeconds = 0;   // Suche
+	double pathSeconds = 0;     // constructPath
+	double seconds = 0;         // Gesamte Laufzeit
+} solve_stats_t;
+
+typedef struct solve_result_t
+{
+	Status status = Unknown;
+	std::vector<point_t> path; // Leer, wenn keine Loesung gefunden wurde
+	uint32_t moves = 0;        // Zuege zu Batterien in der Loesung
+	const char *error = nullptr; // Grund, wenn das Spielfeld fehlerhaft war (dann Unknown)
+	solve_stats_t stats;
+} solve_result_t;
+
+// Liest ein Spielfeld ein; false bei fehlerhafter Datei
+bool readBoard(const char *path, map_t &map, std::ostream &errors = std::cerr);
+
+// Loest ein eingelesenes Spielfeld unter den Grenzen aus options.
+// Jeder Aufruf arbeitet auf einer eigenen Kopie, Aufrufe aus
+// mehreren Threads sind daher moeglich.
+solve_result_t solveBoard(const map_t &board, solve_options_t options);
+
+// Liest das Spielfeld aus der Datei und loest es
+std::vector<point_t> solveGame(const char* path, solve_options_t options);
+
+// Loest ein bereits eingelesenes Spielfeld, siehe solveBoard
+std::vector<point_t> solveGame(const map_t &board, solve_options_t options);
@@ -0,0 +1,144 @@
+#include "transposition.hpp"
+
+/********************
+ *    Konstanten    *
+ ********************/
+
+static const size_t TT_WAYS = 4;            // Eintraege pro Bucket
+static const size_t TT_INITIAL = 1 << 12;   // Anfangsgroesse in Eintraegen
+
+/****************************
+ *    Statische Methoden    *
+ ****************************/
+
+static uint64_t mix(uint64_t x);
+
+/*********************************************
+ *    Statische Methoden Implementationen    *
+ *********************************************/
+
+// splitmix64 Finalizer; ersetzt eine Tabelle mit Zufallszahlen,
+// da die Ladungen nicht nach oben beschraenkt sind
+static uint64_t mix(uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ull;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+/************************************************
+ *    Oeffentliche Methoden Implementationen    *
+ ************************************************/
+
+uint64_t zobristBattery(uint32_t id, uint32_t charge)
+{
+	return mix(((uint64_t)id << 32) | charge);
+}
+
+uint64_t zobristRobot(uint32_t position, uint32_t charge)
+{
+	// Oberstes Bit trennt die Schluessel von denen der Batterien
+	return mix(((uint64_t)(position | 0x80000000u) << 32) | charge);
+}
+
+// Setzt die Tabelle zurueck; bytes = 0 deaktiviert sie
+void transposition_t::init(size_t bytes)
+{
+	capacity = 1;
+	while (capacity * 2 * sizeof(tt_entry_t) <= bytes)
+		capacity *= 2;
+
+	if (capacity < TT_WAYS)
+		capacity = 0;
+
+	used = 0;
+	entries.assign(capacity < TT_INITIAL ? capacity : TT_INITIAL, { 0, 0 });
+}
+
+// Verdoppelt die Tabelle und verteilt die Eintraege neu
+void transposition_t::grow()
+{
+	std::vector<tt_entry_t> old(entries.size() * 2, { 0, 0 });
+	old.swap(entries);
+
+	used = 0;
+	for (auto entry : old)
+		if (entry.key)
+			insert(entry.key, entry.depth);
+}
+
+// Traegt den Zustand ein. Gibt false zurueck, wenn er bereits
+// in gleicher oder geringerer Tiefe erreicht wurde.
+bool transposition_t::insert(uint64_t key, uint32_t depth)
+{
+	if (entries.empty())
+		return true;
+
+	if (used * 2 > entries.size() && entries.size() < capacity)
+		grow();
+
+	key |= 1; // 0 markiert leere Eintraege
+
+	size_t buckets = entries.size() / TT_WAYS;
+	tt_entry_t *bucket = &entries[(key >> 1) % buckets * TT_WAYS];
+	tt_entry_t *victim = bucket;
+
+	for (size_t i = 0; i < TT_WAYS; i++)
+	{
+		tt_entry_t &entry = bucket[i];
+
+		if (entry.key == key)
+		{
+			if (entry.depth <= depth)
+				return false;
+
+			entry.depth = depth;
+			return true;
+		}
+
+		if (entry.key == 0)
+		{
+			victim = &entry;
+			break;
+		}
+
+		if (entry.depth > victim->depth)
+			victim = &entry;
+	}
+
+	if (victim->key == 0)
+		used++;
+
+	*victim = { key, depth };
+	return true;
+}
+
+// Entfernt den Zustand, damit er erneut erzeugt werden kann.
+// Die Luecke wird mit dem letzten Eintrag des Buckets gefuellt,
+// da insert die Suche beim ersten leeren Eintrag beendet.
+void transposition_t::erase(uint64_t key)
+{
+	if (entries.empty())
+		return;
+
+	key |= 1;
+
+	size_t buckets = entries.size() / TT_WAYS;
+	tt_entry_t *bucket = &entries[(key >> 1) % buckets * TT_WAYS];
+
+	for (size_t i = 0; i < TT_WAYS && bucket[i].key; i++)
+	{
+		if (bucket[i].key != key)
+			continue;
+
+		size_t last = i;
+		while (last + 1 < TT_WAYS && bucket[last + 1].key)
+			last++;
+
+		bucket[i] = bucket[last];
+		bucket[last] = { 0, 0 };
+		used--;
+		return;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**************************
+ *    Globale typedefs    *
+ **************************/
+
+// Eintrag der Transpositionstabelle
+typedef struct tt_entry_t
+{
+	uint64_t key;   // Zobrist-Hash des Zustands (0 = leer)
+	uint32_t depth; // Geringste Tiefe, in der der Zustand erreicht wurde
+} tt_entry_t;
+
+// Transpositionstabelle mit begrenztem Speicher.
+// Die Eintraege sind in Buckets zu je TT_WAYS Eintraegen gruppiert.
+// Die Tabelle waechst bis zur angegebenen Groesse, danach wird
+// im vollen Bucket der Eintrag mit der groessten Tiefe ersetzt,
+// da flache Zustaende die groesseren Teilbaeume abschneiden.
+typedef struct transposition_t
+{
+	std::vector<tt_entry_t> entries;
+	size_t capacity = 0; // Maximale Anzahl Eintraege
+	size_t used = 0;     // Belegte Eintraege
+
+	void init(size_t bytes);
+	void grow();
+	bool insert(uint64_t key, uint32_t depth);
+	void erase(uint64_t key);
+} transposition_t;
+
+/***************************************
+ *    Globale Methodendeklarationen    *
+ ***************************************/
+
+uint64_t zobristBattery(uint32_t id, uint32_t charge);
+uint64_t zobristRobot(uint32_t position, uint32_t charge);
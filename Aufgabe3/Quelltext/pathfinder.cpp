@@ -1,14 +1,14 @@
 #include "pathfinder.hpp"
+#include "../../Gemeinsam/reader.hpp"
 
 #include <map>
 #include <vector>
-#include <regex>
-#include <fstream>
 #include <iostream>
 #include <cmath>
 #include <set>
 #include <limits>
 #include <queue>
+#include <algorithm>
 
 /*
  * Implementation der Structs
@@ -269,79 +269,83 @@ std::vector<Worker> findFewestTurnPaths(
 // Liest die Datei aus
 void parseFile(char* filePath)
 {
-	std::ifstream file(filePath);
-	std::regex r("\\d+");
+	reader_t reader;
+	std::vector<uint32_t> values;
 
-	if (file.is_open())
+	// Bricht mit der fehlerhaften Zeile ab
+	auto fail = [&reader, filePath]()
 	{
-		std::string line;
-
-		std::getline(file, line);
-		int count = std::stoi(line);
-
-		// Naechste Zeile mithilfe des Regex einlesen
-		std::getline(file, line);
-		std::sregex_iterator it(line.begin(), line.end(), r);
-		int x = std::stoi((*it)[0]);      // X-Wert aus der Datei lesen
-		int y = std::stoi((*(++it))[0]);  // Y-Wert aus der Datei lesen
-		start = lookup.size();            // Eine Zahl dem Startknoten vergeben
-		lookup.push_back({x, y});         // In die Lookup Table einspeichern
-
-		std::getline(file, line);
-		it = std::sregex_iterator(line.begin(), line.end(), r);
-		x = std::stoi((*it)[0]);
-		y = std::stoi((*(++it))[0]);
-		end = lookup.size();
-		lookup.push_back({x, y});
-
-		// Alle restlichen Kanten einlesen
-		while(count-- > 0)
-		{
-			std::getline(file, line);
-			it = std::sregex_iterator(line.begin(), line.end(), r);
+		std::cerr << "Falsche oder korrupte Datei: " << filePath << ":" << reader.line
+			<< ": " << reader.error << std::endl;
+		exit(-1);
+	};
 
-			int x1 = std::stoi((*it)[0]);      // X-Wert des ersten Knoten
-			int y1 = std::stoi((*(++it))[0]);  // Y-Wert des ersten Knoten
-			int x2 = std::stoi((*(++it))[0]);  // X-Wert des zweiten Knoten
-			int y2 = std::stoi((*(++it))[0]);  // Y-Wert des zweiten Knoten
+	if (!reader.open(filePath))
+	{
+		std::cerr << "Falsche oder korrupte Datei" << std::endl;
+		exit(-1);
+	}
 
-			int nodeA;
-			int nodeB;
+	if (!reader.readLine(values, 1))
+		fail();
 
-			Point p = {x1, y1};
+	// Bleibt vorzeichenlos, eine zu grosse Anzahl endet am Dateiende
+	uint32_t count = values[0];
 
-			// Ist der Knoten schon in der Lookup Table vorhanden?
-			auto it = std::find(lookup.begin(), lookup.end(), p);
-			if (it == lookup.end())
-			{
-				// Falls nicht, dann Punkt und Index speichern
-				nodeA = lookup.size();
-				lookup.push_back(p);
-			}
-			else
-				// Andernfalls nur den Index des Knoten auslesen
-				nodeA = std::distance(lookup.begin(), it);
+	// Startknoten einlesen
+	if (!reader.readLine(values, 2))
+		fail();
 
-			p = {x2, y2};
-			it = std::find(lookup.begin(), lookup.end(), p);
-			if (it == lookup.end())
-			{
-				nodeB = lookup.size();
-				lookup.push_back(p);
-			}
-			else
-				nodeB = std::distance(lookup.begin(), it);
+	start = lookup.size(); // Eine Zahl dem Startknoten vergeben
+	lookup.push_back({(int)values[0], (int)values[1]}); // In die Lookup Table einspeichern
 
-			// Kante in der Adjazenzliste speichern
-			adjList[nodeA].insert(nodeB);
-			adjList[nodeB].insert(nodeA);
-		}
-	}
-	else
+	// Zielknoten einlesen
+	if (!reader.readLine(values, 2))
+		fail();
+
+	end = lookup.size();
+	lookup.push_back({(int)values[0], (int)values[1]});
+
+	// Alle restlichen Kanten einlesen
+	while(count--)
 	{
-		std::cerr << "Falsche oder korrupte Datei" << std::endl;
-		exit(-1);
+		if (!reader.readLine(values, 4))
+			fail();
+
+		int x1 = values[0]; // X-Wert des ersten Knoten
+		int y1 = values[1]; // Y-Wert des ersten Knoten
+		int x2 = values[2]; // X-Wert des zweiten Knoten
+		int y2 = values[3]; // Y-Wert des zweiten Knoten
+
+		int nodeA;
+		int nodeB;
+
+		Point p = {x1, y1};
+
+		// Ist der Knoten schon in der Lookup Table vorhanden?
+		auto it = std::find(lookup.begin(), lookup.end(), p);
+		if (it == lookup.end())
+		{
+			// Falls nicht, dann Punkt und Index speichern
+			nodeA = lookup.size();
+			lookup.push_back(p);
+		}
+		else
+			// Andernfalls nur den Index des Knoten auslesen
+			nodeA = std::distance(lookup.begin(), it);
+
+		p = {x2, y2};
+		it = std::find(lookup.begin(), lookup.end(), p);
+		if (it == lookup.end())
+		{
+			nodeB = lookup.size();
+			lookup.push_back(p);
+		}
+		else
+			nodeB = std::distance(lookup.begin(), it);
+
+		// Kante in der Adjazenzliste speichern
+		adjList[nodeA].insert(nodeB);
+		adjList[nodeB].insert(nodeA);
 	}
-	
-	file.close();
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <cstdint>
+#include <cstddef>
 
 /*
  * Struct Definitionen für die jeweiligen Methoden
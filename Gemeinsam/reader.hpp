@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Gemeinsamer Parser fuer die Eingabedateien von Aufgabe 1 und 3.
+// Die Datei wird einmal komplett in den Speicher gelesen und dann
+// Zeile fuer Zeile direkt im Puffer zerlegt, ohne Zeilen zu kopieren.
+// Wie beim frueheren regulaeren Ausdruck \d+ zaehlt jede Folge von
+// Ziffern als Zahl, alle anderen Zeichen trennen die Zahlen nur.
+
+/**************************
+ *    Globale typedefs    *
+ **************************/
+
+typedef struct reader_t
+{
+	std::vector<char> data;
+	size_t pos = 0;        // Anfang der naechsten Zeile
+	uint32_t line = 0;     // Nummer der zuletzt gelesenen Zeile (ab 1)
+	const char *error = nullptr; // Grund des letzten Fehlers
+
+	// Liest die ganze Datei ein; false, wenn sie nicht lesbar ist
+	bool open(const char *path)
+	{
+		FILE *file = std::fopen(path, "rb");
+
+		if (!file)
+			return false;
+
+		std::fseek(file, 0, SEEK_END);
+		long size = std::ftell(file);
+		std::fseek(file, 0, SEEK_SET);
+
+		data.resize(size > 0 ? size : 0);
+		bool ok = size >= 0 && std::fread(data.data(), 1, data.size(), file) == data.size();
+		std::fclose(file);
+
+		pos = 0;
+		line = 0;
+		error = nullptr;
+		return ok;
+	}
+
+	// Liest alle Zahlen der naechsten Zeile nach values. Gibt false
+	// zurueck, wenn es weniger als count sind oder eine Zahl nicht
+	// in 32 Bit passt; der Grund steht dann in error.
+	bool readLine(std::vector<uint32_t> &values, size_t count)
+	{
+		values.clear();
+
+		if (pos >= data.size())
+		{
+			line++;
+			error = "unerwartetes Dateiende";
+			return false;
+		}
+
+		const char *c = data.data() + pos;
+		const char *end = data.data() + data.size();
+		line++;
+
+		while (c < end && *c != '\n')
+		{
+			if (*c < '0' || *c > '9')
+			{
+				c++;
+				continue;
+			}
+
+			uint64_t value = 0;
+
+			while (c < end && *c >= '0' && *c <= '9')
+			{
+				value = value * 10 + (*c++ - '0');
+
+				if (value > UINT32_MAX)
+				{
+					error = "Zahl zu gross";
+					return false;
+				}
+			}
+
+			values.push_back((uint32_t)value);
+		}
+
+		pos = c - data.data() + 1;
+
+		if (values.size() < count)
+		{
+			error = "zu wenige Zahlen";
+			return false;
+		}
+
+		return true;
+	}
+} reader_t;